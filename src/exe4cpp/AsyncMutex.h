@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_ASYNCMUTEX_H
+#define EXE4CPP_ASYNCMUTEX_H
+
+#include "exe4cpp/AsyncSemaphore.h"
+
+namespace exe4cpp
+{
+
+/**
+* Mutex that can be held across several asynchronous steps without blocking a thread.
+*
+* The owner calls unlock() when it is done, which may happen on a different executor than the one
+* that acquired the lock. Waiters are resumed in FIFO order on their own executor.
+*/
+class AsyncMutex final
+{
+public:
+    AsyncMutex() : semaphore{1}
+    {}
+
+    // Uncopyable
+    AsyncMutex(const AsyncMutex&) = delete;
+    AsyncMutex& operator=(const AsyncMutex&) = delete;
+
+    static std::shared_ptr<AsyncMutex> create()
+    {
+        return std::make_shared<AsyncMutex>();
+    }
+
+    /// @return true if the lock was acquired without waiting
+    bool try_lock()
+    {
+        return this->semaphore.try_acquire();
+    }
+
+    /// Post the action to the executor once the lock is owned
+    void async_lock(const std::shared_ptr<IExecutor>& executor, const action_t& action)
+    {
+        this->semaphore.async_acquire(executor, action);
+    }
+
+    void unlock()
+    {
+        this->semaphore.release();
+    }
+
+    bool is_locked() const
+    {
+        return this->semaphore.available() <= 0;
+    }
+
+private:
+    AsyncSemaphore semaphore;
+};
+
+}
+
+#endif
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_ASYNCSEMAPHORE_H
+#define EXE4CPP_ASYNCSEMAPHORE_H
+
+#include "exe4cpp/IExecutor.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace exe4cpp
+{
+
+/**
+* Counting semaphore whose waiters are resumed on their own executor instead of blocking a thread.
+*
+* The count is an atomic: acquiring an available permit and releasing a permit nobody waits for are
+* lock-free. A negative count is the number of waiters, whose list is protected by a mutex that is
+* only taken on the contended path. A release that finds no waiter in the list yet (the acquirer
+* decremented the count but has not queued itself) leaves a hand-off that the acquirer consumes.
+*/
+class AsyncSemaphore final
+{
+public:
+    explicit AsyncSemaphore(int64_t permits) : count{permits}
+    {}
+
+    // Uncopyable
+    AsyncSemaphore(const AsyncSemaphore&) = delete;
+    AsyncSemaphore& operator=(const AsyncSemaphore&) = delete;
+
+    static std::shared_ptr<AsyncSemaphore> create(int64_t permits)
+    {
+        return std::make_shared<AsyncSemaphore>(permits);
+    }
+
+    /// @return true if a permit was acquired without waiting
+    bool try_acquire()
+    {
+        auto current = this->count.load(std::memory_order_relaxed);
+        while (current > 0)
+        {
+            if (this->count.compare_exchange_weak(current, current - 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Acquire a permit and post the action to the executor once it is owned
+    void async_acquire(const std::shared_ptr<IExecutor>& executor, const action_t& action)
+    {
+        if (this->count.fetch_sub(1, std::memory_order_acquire) > 0)
+        {
+            executor->post(action);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            if (this->handoffs == 0)
+            {
+                this->waiters.push_back(waiter_t{executor, action});
+                return;
+            }
+            --this->handoffs;
+        }
+
+        executor->post(action);
+    }
+
+    /// Release a permit, resuming the oldest waiter if there is one
+    void release()
+    {
+        if (this->count.fetch_add(1, std::memory_order_release) >= 0)
+        {
+            return;
+        }
+
+        waiter_t waiter;
+        {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            if (this->waiters.empty())
+            {
+                ++this->handoffs;
+                return;
+            }
+            waiter = std::move(this->waiters.front());
+            this->waiters.pop_front();
+        }
+
+        waiter.executor->post(waiter.action);
+    }
+
+    /// @return the number of available permits, negative values are the number of waiters
+    int64_t available() const
+    {
+        return this->count.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct waiter_t
+    {
+        std::shared_ptr<IExecutor> executor;
+        action_t action;
+    };
+
+    std::atomic<int64_t> count;
+
+    std::mutex mutex;
+    size_t handoffs = 0;
+    std::deque<waiter_t> waiters;
+};
+
+}
+
+#endif
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_BOUNDEDQUEUE_H
+#define EXE4CPP_BOUNDEDQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace exe4cpp
+{
+
+/**
+* Lock-free, fixed capacity, multi-producer multi-consumer queue.
+*
+* All the cells are allocated on construction, so pushing and popping never allocates. Each cell carries
+* a sequence number that tells producers and consumers whether it is free for the current lap around
+* the ring (D. Vyukov's bounded MPMC queue).
+*
+* The capacity is rounded up to the next power of two, with a minimum of 2. T must be default constructible and move assignable.
+*/
+template <typename T>
+class BoundedQueue final
+{
+public:
+    explicit BoundedQueue(size_t capacity) :
+        mask{round_up_pow2(capacity) - 1},
+        cells{new cell_t[mask + 1]}
+    {
+        for (size_t i = 0; i <= mask; ++i)
+        {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Uncopyable
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /// @return false if the queue is full
+    bool try_push(const T& value)
+    {
+        T copy{value};
+        return this->try_push(std::move(copy));
+    }
+
+    /// @return false if the queue is full, in which case value is left untouched
+    bool try_push(T&& value)
+    {
+        auto pos = this->enqueue_pos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& cell = this->cells[pos & this->mask];
+            const auto seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0)
+            {
+                if (this->enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = this->enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @return false if the queue is empty
+    bool try_pop(T& value)
+    {
+        auto pos = this->dequeue_pos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& cell = this->cells[pos & this->mask];
+            const auto seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (this->dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    value = std::move(cell.value);
+                    cell.value = T{};
+                    cell.sequence.store(pos + this->mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = this->dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @return an approximation of the number of items, exact when no push or pop is in progress
+    size_t size_approx() const
+    {
+        const auto tail = this->enqueue_pos.load(std::memory_order_acquire);
+        const auto head = this->dequeue_pos.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const
+    {
+        return this->mask + 1;
+    }
+
+private:
+    struct cell_t
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    static size_t round_up_pow2(size_t value)
+    {
+        size_t result = 2;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t mask;
+    const std::unique_ptr<cell_t[]> cells;
+
+    // keep producers and consumers on different cache lines
+    char pad0[64];
+    std::atomic<size_t> enqueue_pos{0};
+    char pad1[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> dequeue_pos{0};
+};
+
+}
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_CACHEDTIMESOURCE_H
+#define EXE4CPP_CACHEDTIMESOURCE_H
+
+#include "exe4cpp/ISteadyTimeSource.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace exe4cpp
+{
+
+/**
+* Time source that reads the underlying clock once and returns the same timestamp until it is
+* invalidated.
+*
+* The BasicExecutor and StrandExecutor invalidate a CachedTimeSource they are configured with before
+* running each handler, so all the get_time() calls made by a handler, and the timers it starts,
+* share a single clock read. A timestamp is therefore behind the real time by at most the time
+* spent so far in the running handler.
+*
+* The cache is per thread: invalidate() only affects the calling thread, and the threads of a pool
+* never write a shared cache line. Each thread keeps a single slot, so a thread alternating between
+* several sources reads the clock again each time it switches. Timestamps never go backwards on a
+* thread.
+*/
+class CachedTimeSource final : public ISteadyTimeSource
+{
+public:
+    /// @param source underlying clock, steady_clock is used if null
+    explicit CachedTimeSource(const std::shared_ptr<ISteadyTimeSource>& source = nullptr) :
+        source{source},
+        id{next_id()}
+    {}
+
+    // Uncopyable
+    CachedTimeSource(const CachedTimeSource&) = delete;
+    CachedTimeSource& operator=(const CachedTimeSource&) = delete;
+
+    static std::shared_ptr<CachedTimeSource> create(const std::shared_ptr<ISteadyTimeSource>& source = nullptr)
+    {
+        return std::make_shared<CachedTimeSource>(source);
+    }
+
+    /// The next call to get_time() on the calling thread reads the underlying clock
+    void invalidate()
+    {
+        auto& slot = local_slot();
+        if (slot.owner == this->id)
+        {
+            slot.is_valid = false;
+        }
+    }
+
+    virtual steady_time_t get_time() override
+    {
+        auto& slot = local_slot();
+        if (slot.owner != this->id || !slot.is_valid)
+        {
+            slot.owner = this->id;
+            slot.cached = this->source ? this->source->get_time() : std::chrono::steady_clock::now();
+            slot.is_valid = true;
+        }
+        return slot.cached;
+    }
+
+private:
+    struct slot_t
+    {
+        // id of the source the timestamp belongs to, ids are never reused unlike addresses
+        uint64_t owner = 0;
+        bool is_valid = false;
+        steady_time_t cached;
+    };
+
+    static slot_t& local_slot()
+    {
+        static thread_local slot_t slot;
+        return slot;
+    }
+
+    static uint64_t next_id()
+    {
+        static std::atomic<uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    const std::shared_ptr<ISteadyTimeSource> source;
+    const uint64_t id;
+};
+
+}
+
+#endif
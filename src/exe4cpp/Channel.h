@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_CHANNEL_H
+#define EXE4CPP_CHANNEL_H
+
+#include "exe4cpp/BoundedQueue.h"
+#include "exe4cpp/IExecutor.h"
+
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <mutex>
+
+namespace exe4cpp
+{
+
+/**
+* Bounded, typed channel used to pass messages between executors.
+*
+* Messages are stored in a preallocated BoundedQueue, so the fast path of sending and receiving is
+* lock-free and never allocates. When the channel is full, async_send() parks the message until a
+* receiver makes room. When the channel is empty, async_receive() parks the handler until a message
+* is sent.
+*
+* Parked messages enter the channel one at a time, in the order they were parked, and no message
+* bypasses them while any is parked, so the messages of a producer are received in the order they
+* were sent. Parked messages are held outside the preallocated ring, in a list bounded by max_parked:
+* past it async_send() rejects the message. The list is not bounded by default, the capacity then only
+* bounds memory if producers wait for on_sent before sending their next message.
+*
+* Parked senders and receivers are resumed by posting onto the executor they provided, so callbacks
+* always run in the context of their own executor. The waiter lists are protected by a mutex that is
+* only taken on the slow path.
+*/
+template <typename T>
+class Channel final : public std::enable_shared_from_this<Channel<T>>
+{
+public:
+    using receive_handler_t = std::function<void(T&&)>;
+
+    /// The capacity is rounded up to the next power of two by the BoundedQueue, see capacity()
+    explicit Channel(size_t capacity, size_t max_parked = std::numeric_limits<size_t>::max()) :
+        queue{capacity},
+        max_parked{max_parked}
+    {}
+
+    // Uncopyable
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    /**
+    * The capacity is rounded up to the next power of two (with a minimum of 2), e.g. create(3) holds 4 messages.
+    * At most max_parked messages wait for room in async_send(), not bounded by default.
+    */
+    static std::shared_ptr<Channel> create(size_t capacity, size_t max_parked = std::numeric_limits<size_t>::max())
+    {
+        return std::make_shared<Channel>(capacity, max_parked);
+    }
+
+    /// @return false if the channel is full or messages are parked by async_send()
+    bool try_send(const T& value)
+    {
+        T copy{value};
+        return this->try_send(std::move(copy));
+    }
+
+    /// @return false if the channel is full or messages are parked by async_send()
+    bool try_send(T&& value)
+    {
+        return !this->has_senders.load(std::memory_order_acquire) && this->push(std::move(value));
+    }
+
+    /// @return false if the channel is empty
+    bool try_receive(T& value)
+    {
+        if (!this->queue.try_pop(value))
+        {
+            return false;
+        }
+
+        this->on_popped();
+        return true;
+    }
+
+    /**
+    * Receive up to maximum messages without waiting
+    *
+    * @return the number of messages passed to the handler
+    */
+    template <typename handler_t>
+    size_t try_receive_many(const handler_t& handler, size_t maximum)
+    {
+        size_t count = 0;
+        T value;
+        while (count < maximum && this->queue.try_pop(value))
+        {
+            ++count;
+            handler(std::move(value));
+        }
+
+        if (count > 0)
+        {
+            this->on_popped();
+        }
+
+        return count;
+    }
+
+    /**
+    * Send a message, waiting for room if the channel is full.
+    *
+    * on_sent (optional) is posted to the executor once the message is in the channel.
+    *
+    * @return false if the message was rejected because max_parked messages are already waiting, on_sent is not posted
+    */
+    bool async_send(const std::shared_ptr<IExecutor>& executor, const T& value, const action_t& on_sent = nullptr)
+    {
+        T copy{value};
+        if (this->try_send(std::move(copy)))
+        {
+            if (on_sent)
+            {
+                executor->post(on_sent);
+            }
+            return true;
+        }
+
+        // a failed push leaves the copy untouched
+        return this->wait_for_room(send_waiter_t{executor, std::move(copy), on_sent});
+    }
+
+    /// @return the number of messages parked by async_send(), including the one being retried
+    size_t num_parked()
+    {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        return this->senders.size() + (this->is_retrying ? 1 : 0);
+    }
+
+    /**
+    * Receive between 1 and maximum messages, waiting if the channel is empty.
+    *
+    * The handler is invoked once per message from a single action posted to the executor.
+    */
+    void async_receive(const std::shared_ptr<IExecutor>& executor, const receive_handler_t& handler, size_t maximum = 1)
+    {
+        receive_waiter_t waiter{executor, handler, maximum == 0 ? 1 : maximum};
+        if (this->queue.size_approx() > 0)
+        {
+            this->resume(std::move(waiter));
+        }
+        else
+        {
+            this->wait_for_message(std::move(waiter));
+        }
+    }
+
+    /// @return an approximation of the number of messages in the channel
+    size_t size_approx() const
+    {
+        return this->queue.size_approx();
+    }
+
+    size_t capacity() const
+    {
+        return this->queue.capacity();
+    }
+
+private:
+    struct send_waiter_t
+    {
+        std::shared_ptr<IExecutor> executor;
+        T value;
+        action_t on_sent;
+    };
+
+    struct receive_waiter_t
+    {
+        std::shared_ptr<IExecutor> executor;
+        receive_handler_t handler;
+        size_t maximum;
+    };
+
+    bool push(T&& value)
+    {
+        if (!this->queue.try_push(std::move(value)))
+        {
+            return false;
+        }
+
+        // pairs with the fence in wait_for_message(), either we see the waiter or it sees the message
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (this->has_receivers.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            this->wake_receiver();
+        }
+
+        return true;
+    }
+
+    void on_popped()
+    {
+        // pairs with the fence in park_sender(), either we see the waiter or it sees the room
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (this->has_senders.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            this->wake_sender();
+        }
+    }
+
+    bool wait_for_room(send_waiter_t&& waiter)
+    {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        // the message being retried is still parked
+        if (this->senders.size() + (this->is_retrying ? 1 : 0) >= this->max_parked)
+        {
+            return false;
+        }
+        this->senders.push_back(std::move(waiter));
+        this->park_sender();
+        return true;
+    }
+
+    // must be called with the mutex held while a message is parked
+    void park_sender()
+    {
+        this->has_senders.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (this->queue.size_approx() < this->queue.capacity())
+        {
+            this->wake_sender();
+        }
+    }
+
+    void wait_for_message(receive_waiter_t&& waiter)
+    {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        this->receivers.push_back(std::move(waiter));
+        this->has_receivers.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (this->queue.size_approx() > 0)
+        {
+            this->wake_receiver();
+        }
+    }
+
+    // must be called with the mutex held. The parked messages are retried one at a time to keep their order.
+    void wake_sender()
+    {
+        if (this->is_retrying || this->senders.empty())
+        {
+            return;
+        }
+
+        auto waiter = std::move(this->senders.front());
+        this->senders.pop_front();
+        this->is_retrying = true;
+
+        auto executor = waiter.executor;
+        auto retry = [self = this->shared_from_this(), waiter = std::move(waiter)]() mutable
+        {
+            // a failed push leaves the value untouched
+            const auto is_sent = self->push(std::move(waiter.value));
+            {
+                std::lock_guard<std::mutex> lock{self->mutex};
+                self->is_retrying = false;
+                if (!is_sent)
+                {
+                    // the room was taken before the retry ran, the message stays first in line
+                    self->senders.push_front(std::move(waiter));
+                }
+
+                if (self->senders.empty())
+                {
+                    self->has_senders.store(false, std::memory_order_relaxed);
+                }
+                else
+                {
+                    self->park_sender();
+                }
+            }
+
+            if (is_sent && waiter.on_sent)
+            {
+                waiter.on_sent();
+            }
+        };
+        executor->post(std::move(retry));
+    }
+
+    // must be called with the mutex held
+    void wake_receiver()
+    {
+        if (this->receivers.empty())
+        {
+            return;
+        }
+
+        auto waiter = std::move(this->receivers.front());
+        this->receivers.pop_front();
+        this->has_receivers.store(!this->receivers.empty(), std::memory_order_relaxed);
+
+        this->resume(std::move(waiter));
+    }
+
+    void resume(receive_waiter_t&& waiter)
+    {
+        auto executor = waiter.executor;
+        auto retry = [self = this->shared_from_this(), waiter = std::move(waiter)]() mutable
+        {
+            if (self->try_receive_many(waiter.handler, waiter.maximum) == 0)
+            {
+                // another consumer took the messages first
+                self->wait_for_message(std::move(waiter));
+            }
+        };
+        executor->post(retry);
+    }
+
+    BoundedQueue<T> queue;
+    const size_t max_parked;
+
+    std::atomic<bool> has_senders{false};
+    std::atomic<bool> has_receivers{false};
+
+    std::mutex mutex;
+    // true while the first parked message is being retried, has_senders stays set meanwhile
+    bool is_retrying = false;
+    std::deque<send_waiter_t> senders;
+    std::deque<receive_waiter_t> receivers;
+};
+
+}
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_COARSETIMESOURCE_H
+#define EXE4CPP_COARSETIMESOURCE_H
+
+#include "exe4cpp/ISteadyTimeSource.h"
+
+#if defined(__linux__)
+#include <time.h>
+#endif
+
+namespace exe4cpp
+{
+
+/**
+* Time source backed by CLOCK_MONOTONIC_COARSE on Linux.
+*
+* The coarse clock is read from the vDSO without touching the hardware counter, which makes it
+* several times cheaper than steady_clock, at the cost of only advancing once per scheduler
+* tick. precision() reports the resolution of the clock, i.e. the tick period, typically 1 to 4 ms.
+*
+* CLOCK_MONOTONIC_COARSE shares its origin with CLOCK_MONOTONIC, which backs steady_clock, so
+* the timestamps can be mixed with steady_clock ones, e.g. as asio timer expirations. They are
+* never ahead of steady_clock and usually behind by less than precision(), a bit more when a tick
+* is delayed (tickless idle, virtual machines). Timers started from a coarse timestamp expire
+* early by the same amount.
+*
+* On other platforms, or if the coarse clock is not available, steady_clock is used instead.
+*/
+class CoarseTimeSource final : public ISteadyTimeSource
+{
+public:
+    CoarseTimeSource() : is_coarse{probe_coarse_clock(resolution)}
+    {}
+
+    /// @return true if the coarse clock is used, false if it fell back to steady_clock
+    bool is_coarse_clock() const
+    {
+        return this->is_coarse;
+    }
+
+    /// @return the resolution of the clock, zero when falling back to steady_clock
+    duration_t precision() const
+    {
+        return this->resolution;
+    }
+
+    virtual steady_time_t get_time() override
+    {
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+        if (this->is_coarse)
+        {
+            timespec ts;
+            ::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+            return steady_time_t(std::chrono::duration_cast<duration_t>(std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec)));
+        }
+#endif
+        return std::chrono::steady_clock::now();
+    }
+
+private:
+    static bool probe_coarse_clock(duration_t& resolution)
+    {
+        resolution = duration_t::zero();
+
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+        timespec res;
+        if (::clock_getres(CLOCK_MONOTONIC_COARSE, &res) == 0)
+        {
+            resolution = std::chrono::duration_cast<duration_t>(std::chrono::seconds(res.tv_sec) + std::chrono::nanoseconds(res.tv_nsec));
+            return true;
+        }
+#endif
+
+        return false;
+    }
+
+    duration_t resolution;
+    const bool is_coarse;
+};
+
+}
+
+#endif
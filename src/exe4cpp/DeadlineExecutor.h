@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_DEADLINEEXECUTOR_H
+#define EXE4CPP_DEADLINEEXECUTOR_H
+
+#include "exe4cpp/IExecutor.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace exe4cpp
+{
+
+/**
+* What a DeadlineExecutor does with an event whose deadline has passed when it is dequeued
+*/
+enum class ExpiredPolicy
+{
+    /// execute the event late
+    execute,
+    /// discard the event
+    drop,
+    /// post the event to the redirect executor instead
+    redirect
+};
+
+/**
+* Executor that runs events in earliest-deadline-first order instead of FIFO.
+*
+* Events are kept in a min-heap ordered by deadline, with ties broken by post order, and are executed
+* one at a time by a drain action posted to the underlying executor (e.g. a StrandExecutor). Events
+* posted without a deadline, and expired timers, get the default relative deadline.
+*
+* When the executor falls behind, events whose deadline has already passed at dequeue time can be
+* dropped or redirected instead of being executed late and compounding the backlog.
+*/
+class DeadlineExecutor final :
+    public IExecutor,
+    public std::enable_shared_from_this<DeadlineExecutor>
+{
+public:
+    DeadlineExecutor(
+        const std::shared_ptr<IExecutor>& executor,
+        const duration_t& default_deadline,
+        ExpiredPolicy policy = ExpiredPolicy::execute,
+        const std::shared_ptr<IExecutor>& redirect = nullptr
+    ) : executor{executor},
+        redirect{redirect},
+        default_deadline{default_deadline},
+        policy{(policy == ExpiredPolicy::redirect && !redirect) ? ExpiredPolicy::drop : policy}
+    {}
+
+    // Uncopyable
+    DeadlineExecutor(const DeadlineExecutor&) = delete;
+    DeadlineExecutor& operator=(const DeadlineExecutor&) = delete;
+
+    static std::shared_ptr<DeadlineExecutor> create(
+        const std::shared_ptr<IExecutor>& executor,
+        const duration_t& default_deadline,
+        ExpiredPolicy policy = ExpiredPolicy::execute,
+        const std::shared_ptr<IExecutor>& redirect = nullptr
+    )
+    {
+        return std::make_shared<DeadlineExecutor>(executor, default_deadline, policy, redirect);
+    }
+
+    /// Post an event that should be executed before the deadline
+    void post(const steady_time_t& deadline, const action_t& action)
+    {
+        {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            this->queue.push_back(item_t{deadline, this->next_seq++, action});
+            std::push_heap(this->queue.begin(), this->queue.end(), later_t{});
+            if (this->is_scheduled)
+            {
+                return;
+            }
+            this->is_scheduled = true;
+        }
+
+        this->schedule();
+    }
+
+    /// @return the number of events that were dropped or redirected because their deadline had passed
+    size_t num_expired() const
+    {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        return this->num_expired_;
+    }
+
+    // ---- Implement IExecutor -----
+
+    using IExecutor::start;
+
+    virtual Timer start(const duration_t& duration, const action_t& action) override
+    {
+        return this->start(this->get_time() + duration, action);
+    }
+
+    virtual Timer start(const steady_time_t& expiration, const action_t& action) override
+    {
+        auto callback = [self = shared_from_this(), expiration, action = action]()
+        {
+            self->post(expiration + self->default_deadline, action);
+        };
+        return this->executor->start(expiration, std::move(callback));
+    }
+
+    virtual void post(const action_t& action) override
+    {
+        this->post(this->get_time() + this->default_deadline, action);
+    }
+
+    virtual steady_time_t get_time() override
+    {
+        return this->executor->get_time();
+    }
+
+private:
+    // maximum number of events executed by a drain before yielding to the underlying executor
+    static constexpr size_t max_batch = 32;
+
+    struct item_t
+    {
+        steady_time_t deadline;
+        uint64_t seq;
+        action_t action;
+    };
+
+    struct later_t
+    {
+        bool operator()(const item_t& lhs, const item_t& rhs) const
+        {
+            return (lhs.deadline == rhs.deadline) ? (lhs.seq > rhs.seq) : (lhs.deadline > rhs.deadline);
+        }
+    };
+
+    void schedule()
+    {
+        // the drain keeps the executor alive until the queued events have run, it allocates once
+        // per batch of events
+        this->executor->post([self = shared_from_this()]()
+        {
+            self->drain();
+        });
+    }
+
+    void drain()
+    {
+        for (size_t i = 0; i < max_batch; ++i)
+        {
+            // read the clock before taking the lock, the underlying executor may take locks of its own
+            const auto now = (this->policy != ExpiredPolicy::execute) ? this->get_time() : steady_time_t{};
+
+            item_t item;
+            bool is_expired = false;
+            {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                if (this->queue.empty())
+                {
+                    this->is_scheduled = false;
+                    return;
+                }
+
+                std::pop_heap(this->queue.begin(), this->queue.end(), later_t{});
+                item = std::move(this->queue.back());
+                this->queue.pop_back();
+
+                is_expired = (this->policy != ExpiredPolicy::execute) && (item.deadline < now);
+                if (is_expired)
+                {
+                    ++this->num_expired_;
+                }
+            }
+
+            try
+            {
+                if (!is_expired)
+                {
+                    item.action();
+                }
+                else if (this->policy == ExpiredPolicy::redirect)
+                {
+                    this->redirect->post(item.action);
+                }
+            }
+            catch (...)
+            {
+                // the drain is still marked as scheduled, the next one dispatches the remaining events
+                this->schedule();
+                throw;
+            }
+        }
+
+        this->schedule();
+    }
+
+    const std::shared_ptr<IExecutor> executor;
+    const std::shared_ptr<IExecutor> redirect;
+    const duration_t default_deadline;
+    const ExpiredPolicy policy;
+
+    mutable std::mutex mutex;
+    bool is_scheduled = false;
+    uint64_t next_seq = 0;
+    size_t num_expired_ = 0;
+    // min-heap by deadline, maintained with std::push_heap and std::pop_heap so that items can be moved out
+    std::vector<item_t> queue;
+};
+
+}
+
+#endif
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_EVENTLOG_H
+#define EXE4CPP_EVENTLOG_H
+
+#include "exe4cpp/Typedefs.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace exe4cpp
+{
+
+enum class EventKind : uint8_t
+{
+    /// an action was posted
+    post = 1,
+    /// a timer was started
+    start = 2,
+    /// a pending timer was canceled
+    cancel = 3,
+    /// a posted action or an expired timer began to run
+    run = 4,
+    /// the handler that began with the run of the same id returned
+    complete = 5
+};
+
+/**
+* Event of an executor, see RecordingExecutor
+*/
+struct RecordedEvent
+{
+    EventKind kind = EventKind::post;
+    /// time since the start of the recording
+    duration_t time = duration_t::zero();
+    /// the post or timer the event is about, numbered from 0 in the order they were made
+    uint64_t id = 0;
+    /// index of the name of the handler in EventLog::handlers, for posts and starts
+    uint32_t handler = 0;
+    /// expiration of a started timer, relative to the time of the event
+    duration_t delay = duration_t::zero();
+};
+
+/**
+* Events read back from an event log, see EventLogWriter for the format
+*/
+struct EventLog
+{
+    std::vector<std::string> handlers;
+    std::vector<RecordedEvent> events;
+
+    /// @return the time each run of a handler took, in the order they ran
+    std::vector<duration_t> durations(const std::string& handler) const
+    {
+        std::unordered_map<uint64_t, const RecordedEvent*> made;
+        std::unordered_map<uint64_t, duration_t> started;
+        std::vector<duration_t> result;
+
+        for (const auto& event : this->events)
+        {
+            switch (event.kind)
+            {
+            case EventKind::post:
+            case EventKind::start:
+                made[event.id] = &event;
+                break;
+            case EventKind::run:
+                started[event.id] = event.time;
+                break;
+            case EventKind::complete:
+                {
+                    const auto origin = made.find(event.id);
+                    const auto start = started.find(event.id);
+                    if (origin != made.end() && start != started.end() && this->handlers[origin->second->handler] == handler)
+                    {
+                        result.push_back(event.time - start->second);
+                    }
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        return result;
+    }
+};
+
+/**
+* Writes executor events in a compact binary format.
+*
+* The log starts with a magic number and a version. Each record is a kind byte followed by
+* LEB128 varints: the time since the previous record (zigzag-encoded), then the fields of the
+* kind. A handler name is written once, in a record of its own, the first time it is used, and
+* is referred to by its index afterwards. A typical record takes 4 to 8 bytes.
+*
+* Not thread-safe.
+*/
+class EventLogWriter final
+{
+public:
+    static constexpr size_t magic_size = 8;
+    static constexpr uint64_t version = 1;
+    // record holding the name of the next handler index
+    static constexpr uint8_t name_record = 0;
+    /// longest handler name in a log
+    static constexpr size_t max_name_size = 64 * 1024;
+
+    explicit EventLogWriter(std::ostream& output) : output(output)
+    {
+        this->output.write(magic(), magic_size);
+        this->write_varint(version);
+    }
+
+    // Uncopyable
+    EventLogWriter(const EventLogWriter&) = delete;
+    EventLogWriter& operator=(const EventLogWriter&) = delete;
+
+    /// @return the index of a handler name, written to the log the first time
+    uint32_t intern(const std::string& name)
+    {
+        const auto iter = this->names.find(name);
+        if (iter != this->names.end())
+        {
+            return iter->second;
+        }
+
+        if (name.size() > max_name_size)
+        {
+            throw std::invalid_argument("handler name is too long");
+        }
+
+        const auto index = static_cast<uint32_t>(this->names.size());
+        this->names.emplace(name, index);
+
+        this->output.put(static_cast<char>(name_record));
+        this->write_varint(name.size());
+        this->output.write(name.data(), static_cast<std::streamsize>(name.size()));
+        return index;
+    }
+
+    void write(const RecordedEvent& event)
+    {
+        this->output.put(static_cast<char>(event.kind));
+        this->write_varint(zigzag((event.time - this->last_time).count()));
+        this->last_time = event.time;
+        this->write_varint(event.id);
+
+        if (event.kind == EventKind::post || event.kind == EventKind::start)
+        {
+            this->write_varint(event.handler);
+        }
+        if (event.kind == EventKind::start)
+        {
+            this->write_varint(zigzag(event.delay.count()));
+        }
+    }
+
+    void flush()
+    {
+        this->output.flush();
+    }
+
+    /// @return the bytes every log starts with, the terminating null included
+    static const char* magic()
+    {
+        return "EXE4LOG";
+    }
+
+private:
+    static uint64_t zigzag(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    void write_varint(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            this->output.put(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        this->output.put(static_cast<char>(value));
+    }
+
+    std::ostream& output;
+    std::unordered_map<std::string, uint32_t> names;
+    duration_t last_time = duration_t::zero();
+};
+
+/**
+* Reads a log written by an EventLogWriter, throws std::runtime_error if the log is invalid
+*/
+class EventLogReader final
+{
+public:
+    static EventLog read(std::istream& input)
+    {
+        EventLogReader reader{input};
+        return reader.read_all();
+    }
+
+private:
+    explicit EventLogReader(std::istream& input) : input(input)
+    {}
+
+    EventLog read_all()
+    {
+        char header[EventLogWriter::magic_size];
+        if (!this->input.read(header, sizeof(header)) || !std::equal(header, header + sizeof(header), EventLogWriter::magic()))
+        {
+            throw std::runtime_error("not an event log");
+        }
+        if (this->read_varint() != EventLogWriter::version)
+        {
+            throw std::runtime_error("unsupported event log version");
+        }
+
+        EventLog log;
+        duration_t time = duration_t::zero();
+
+        int kind;
+        while ((kind = this->input.get()) != std::char_traits<char>::eof())
+        {
+            if (kind == EventLogWriter::name_record)
+            {
+                log.handlers.push_back(this->read_name());
+                continue;
+            }
+
+            if (kind < static_cast<int>(EventKind::post) || kind > static_cast<int>(EventKind::complete))
+            {
+                throw std::runtime_error("invalid event kind in event log");
+            }
+
+            RecordedEvent event;
+            event.kind = static_cast<EventKind>(kind);
+            time += duration_t(unzigzag(this->read_varint()));
+            event.time = time;
+            event.id = this->read_varint();
+
+            if (event.kind == EventKind::post || event.kind == EventKind::start)
+            {
+                event.handler = static_cast<uint32_t>(this->read_varint());
+                if (event.handler >= log.handlers.size())
+                {
+                    throw std::runtime_error("unknown handler in event log");
+                }
+            }
+            if (event.kind == EventKind::start)
+            {
+                event.delay = duration_t(unzigzag(this->read_varint()));
+            }
+
+            log.events.push_back(event);
+        }
+
+        return log;
+    }
+
+    std::string read_name()
+    {
+        const auto size = this->read_varint();
+        if (size > EventLogWriter::max_name_size)
+        {
+            throw std::runtime_error("invalid handler name in event log");
+        }
+
+        // the size is untrusted, so the name grows with the bytes actually read
+        std::string name;
+        char buffer[256];
+        auto remaining = static_cast<size_t>(size);
+        while (remaining > 0)
+        {
+            const auto count = std::min(remaining, sizeof(buffer));
+            if (!this->input.read(buffer, static_cast<std::streamsize>(count)))
+            {
+                throw std::runtime_error("truncated event log");
+            }
+            name.append(buffer, count);
+            remaining -= count;
+        }
+        return name;
+    }
+
+    static int64_t unzigzag(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    uint64_t read_varint()
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            const auto byte = this->input.get();
+            if (byte == std::char_traits<char>::eof())
+            {
+                throw std::runtime_error("truncated event log");
+            }
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return value;
+            }
+        }
+        throw std::runtime_error("invalid varint in event log");
+    }
+
+    std::istream& input;
+};
+
+}
+
+#endif
@@ -0,0 +1,599 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_FUTURE_H
+#define EXE4CPP_FUTURE_H
+
+#include "exe4cpp/IExecutor.h"
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace exe4cpp
+{
+
+template <typename T> class Future;
+template <typename T> class Promise;
+
+/**
+* Storage of the value of a FutureState, empty for void
+*/
+template <typename T>
+class FutureStorage
+{
+public:
+    using reference_t = const T&;
+
+    template <typename U>
+    void construct(U&& value)
+    {
+        new (&this->storage) T(std::forward<U>(value));
+    }
+
+    void destroy()
+    {
+        reinterpret_cast<T*>(&this->storage)->~T();
+    }
+
+    const T& get() const
+    {
+        return *reinterpret_cast<const T*>(&this->storage);
+    }
+
+    /// @return function(value)
+    template <typename function_t>
+    auto invoke(const function_t& function) const -> decltype(function(std::declval<const T&>()))
+    {
+        return function(this->get());
+    }
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+};
+
+template <>
+class FutureStorage<void>
+{
+public:
+    using reference_t = void;
+
+    void construct() {}
+
+    void destroy() {}
+
+    void get() const {}
+
+    /// @return function()
+    template <typename function_t>
+    auto invoke(const function_t& function) const -> decltype(function())
+    {
+        return function();
+    }
+};
+
+/**
+* State shared by a Promise and its Future, allocated once with std::make_shared.
+*
+* The state ends up holding either a value or an exception. The result and the continuation are
+* published with a single atomic set of flags: whichever of the completion and set_continuation()
+* comes second runs the continuation, so neither side takes a lock. The continuation is given the
+* state rather than capturing it, so a pending continuation never keeps its own state alive, and it
+* is released as soon as it has run.
+*/
+template <typename T>
+class FutureState final : public std::enable_shared_from_this<FutureState<T>>
+{
+public:
+    using continuation_t = std::function<void(const std::shared_ptr<FutureState>&)>;
+
+    FutureState() = default;
+
+    ~FutureState()
+    {
+        if (this->flags.load(std::memory_order_acquire) & value_flag)
+        {
+            this->storage.destroy();
+        }
+    }
+
+    // Uncopyable
+    FutureState(const FutureState&) = delete;
+    FutureState& operator=(const FutureState&) = delete;
+
+    template <typename... args_t>
+    void set_value(args_t&&... args)
+    {
+        this->storage.construct(std::forward<args_t>(args)...);
+        this->complete(value_flag);
+    }
+
+    void set_exception(const std::exception_ptr& exception)
+    {
+        this->exception = exception;
+        this->complete(exception_flag);
+    }
+
+    /// @throw std::future_error with std::future_errc::future_already_retrieved if a continuation is already set
+    void set_continuation(const continuation_t& continuation)
+    {
+        if (this->flags.load(std::memory_order_acquire) & continuation_flag)
+        {
+            throw std::future_error(std::future_errc::future_already_retrieved);
+        }
+
+        this->continuation = continuation;
+        if (this->flags.fetch_or(continuation_flag, std::memory_order_acq_rel) & (value_flag | exception_flag))
+        {
+            this->run_continuation();
+        }
+    }
+
+    /// @return true once the state holds a value or an exception
+    bool is_ready() const
+    {
+        return (this->flags.load(std::memory_order_acquire) & (value_flag | exception_flag)) != 0;
+    }
+
+    bool has_exception() const
+    {
+        return (this->flags.load(std::memory_order_acquire) & exception_flag) != 0;
+    }
+
+    /// @return the exception, the state must hold one
+    const std::exception_ptr& get_exception() const
+    {
+        return this->exception;
+    }
+
+    /// @return the value, or rethrow the exception. The state must be ready.
+    typename FutureStorage<T>::reference_t get() const
+    {
+        if (this->has_exception())
+        {
+            std::rethrow_exception(this->exception);
+        }
+        return this->storage.get();
+    }
+
+    /// @return function(value), or function() for void. The state must hold a value.
+    template <typename function_t>
+    auto invoke(const function_t& function) const -> decltype(std::declval<const FutureStorage<T>&>().invoke(function))
+    {
+        return this->storage.invoke(function);
+    }
+
+private:
+    static constexpr uint8_t value_flag = 0x01;
+    static constexpr uint8_t continuation_flag = 0x02;
+    static constexpr uint8_t exception_flag = 0x04;
+
+    void complete(uint8_t result)
+    {
+        if (this->flags.fetch_or(result, std::memory_order_acq_rel) & continuation_flag)
+        {
+            this->run_continuation();
+        }
+    }
+
+    void run_continuation()
+    {
+        auto continuation = std::move(this->continuation);
+        this->continuation = nullptr;
+        continuation(this->shared_from_this());
+    }
+
+    FutureStorage<T> storage;
+    std::exception_ptr exception;
+    std::atomic<uint8_t> flags{0};
+    continuation_t continuation;
+};
+
+/**
+* Completes a state with the result of a function, or with the exception it throws
+*/
+template <typename T>
+struct FutureCompletion
+{
+    template <typename function_t>
+    static void complete(FutureState<T>& state, const function_t& function)
+    {
+        try
+        {
+            state.set_value(function());
+        }
+        catch (...)
+        {
+            // an exception thrown once the value is set comes from a continuation, not from the function
+            if (state.is_ready())
+            {
+                throw;
+            }
+            state.set_exception(std::current_exception());
+        }
+    }
+};
+
+template <>
+struct FutureCompletion<void>
+{
+    template <typename function_t>
+    static void complete(FutureState<void>& state, const function_t& function)
+    {
+        try
+        {
+            function();
+        }
+        catch (...)
+        {
+            state.set_exception(std::current_exception());
+            return;
+        }
+        state.set_value();
+    }
+};
+
+/**
+* Result of an asynchronous operation that never blocks.
+*
+* Continuations attached with then() are posted to the executor of the caller's choice, so futures can
+* be composed inside strand handlers. A future supports a single continuation, a second then() or
+* notify() throws std::future_error with std::future_errc::future_already_retrieved. A future holds either a
+* value or an exception: an exception thrown by a continuation, or the std::future_error of a Promise
+* destroyed without a value, skips the continuations that follow and reaches the end of the chain.
+*/
+template <typename T>
+class Future final
+{
+    template <typename function_t>
+    struct then_t
+    {
+        using result_t = typename std::decay<decltype(std::declval<const FutureState<T>&>().invoke(std::declval<const function_t&>()))>::type;
+    };
+
+public:
+    using continuation_t = typename FutureState<T>::continuation_t;
+
+    Future() = default;
+
+    explicit Future(const std::shared_ptr<FutureState<T>>& state) : state{state}
+    {}
+
+    bool is_valid() const
+    {
+        return this->state != nullptr;
+    }
+
+    /// @return true once the future holds a value or an exception
+    bool is_ready() const
+    {
+        return this->state->is_ready();
+    }
+
+    /// @return true if the future is ready with an exception
+    bool has_exception() const
+    {
+        return this->state->has_exception();
+    }
+
+    /// @return the value, or rethrow the exception. The future must be ready.
+    typename FutureStorage<T>::reference_t get() const
+    {
+        return this->state->get();
+    }
+
+    /**
+    * Post function(value), or function() for a Future<void>, to the executor once the value is available
+    *
+    * @return a future for the result of the function, or for the exception it throws or the future holds
+    */
+    template <typename function_t>
+    Future<typename then_t<function_t>::result_t> then(const std::shared_ptr<IExecutor>& executor, const function_t& function) const
+    {
+        using result_t = typename then_t<function_t>::result_t;
+
+        auto next = std::make_shared<FutureState<result_t>>();
+        this->notify([next, executor, function](const std::shared_ptr<FutureState<T>>& state)
+        {
+            if (state->has_exception())
+            {
+                next->set_exception(state->get_exception());
+                return;
+            }
+
+            executor->post([state, next, function]()
+            {
+                FutureCompletion<result_t>::complete(*next, [&]() { return state->invoke(function); });
+            });
+        });
+        return Future<result_t>{next};
+    }
+
+    /**
+    * Invoke the continuation in the context that completes the future, or immediately if it is ready
+    *
+    * The continuation must be short and non-blocking. This is used by the combinators, prefer then().
+    */
+    void notify(const continuation_t& continuation) const
+    {
+        this->state->set_continuation(continuation);
+    }
+
+private:
+    std::shared_ptr<FutureState<T>> state;
+};
+
+/**
+* Producer side of a Future. The value or exception must be set at most once.
+*
+* A promise destroyed without a result completes its future with a std::future_error whose code is
+* std::future_errc::broken_promise, so the continuations waiting on it are not stranded.
+*/
+template <typename T>
+class Promise final
+{
+public:
+    Promise() : state{std::make_shared<FutureState<T>>()}
+    {}
+
+    ~Promise()
+    {
+        if (this->state && !this->state->is_ready())
+        {
+            this->state->set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+        }
+    }
+
+    Promise(Promise&&) = default;
+
+    // Uncopyable
+    Promise(const Promise&) = delete;
+    Promise& operator=(const Promise&) = delete;
+
+    Future<T> get_future() const
+    {
+        return Future<T>{this->state};
+    }
+
+    template <typename... args_t>
+    void set_value(args_t&&... args)
+    {
+        this->state->set_value(std::forward<args_t>(args)...);
+    }
+
+    void set_exception(const std::exception_ptr& exception)
+    {
+        this->state->set_exception(exception);
+    }
+
+private:
+    std::shared_ptr<FutureState<T>> state;
+};
+
+template <typename T>
+Future<typename std::decay<T>::type> make_ready_future(T&& value)
+{
+    Promise<typename std::decay<T>::type> promise;
+    promise.set_value(std::forward<T>(value));
+    return promise.get_future();
+}
+
+inline Future<void> make_ready_future()
+{
+    Promise<void> promise;
+    promise.set_value();
+    return promise.get_future();
+}
+
+/**
+* Values collected by when_all(): a vector of the values, nothing for void
+*
+* The inputs complete on any thread, so each value is stored in a slot of its own until the last
+* one completes, rather than in a std::vector<T> whose elements may share a word, e.g. for bool.
+*/
+template <typename T>
+struct WhenAllValues
+{
+    using result_t = std::vector<T>;
+
+    explicit WhenAllValues(size_t count) : count{count}, slots{new slot_t[count]}
+    {}
+
+    void store(size_t index, const FutureState<T>& state)
+    {
+        this->slots[index].value = state.get();
+    }
+
+    void complete(Promise<result_t>& promise)
+    {
+        result_t values;
+        values.reserve(this->count);
+        for (size_t i = 0; i < this->count; ++i)
+        {
+            values.push_back(std::move(this->slots[i].value));
+        }
+        promise.set_value(std::move(values));
+    }
+
+private:
+    struct slot_t
+    {
+        T value;
+    };
+
+    const size_t count;
+    const std::unique_ptr<slot_t[]> slots;
+};
+
+template <>
+struct WhenAllValues<void>
+{
+    using result_t = void;
+
+    explicit WhenAllValues(size_t)
+    {}
+
+    void store(size_t, const FutureState<void>&)
+    {}
+
+    void complete(Promise<void>& promise)
+    {
+        promise.set_value();
+    }
+};
+
+/**
+* @return a future that is ready once all the futures are ready, with their values in the same order,
+* or with the first exception held by one of them
+*
+* T must be default constructible.
+*/
+template <typename T>
+Future<typename WhenAllValues<T>::result_t> when_all(const std::vector<Future<T>>& futures)
+{
+    using result_t = typename WhenAllValues<T>::result_t;
+
+    struct all_state_t
+    {
+        explicit all_state_t(size_t count) : values(count), remaining{count}
+        {}
+
+        Promise<result_t> promise;
+        WhenAllValues<T> values;
+        std::atomic<size_t> remaining;
+        std::atomic<bool> is_complete{false};
+    };
+
+    const auto state = std::make_shared<all_state_t>(futures.size());
+    auto result = state->promise.get_future();
+
+    if (futures.empty())
+    {
+        state->values.complete(state->promise);
+        return result;
+    }
+
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        futures[i].notify([state, i](const std::shared_ptr<FutureState<T>>& future)
+        {
+            if (future->has_exception())
+            {
+                if (!state->is_complete.exchange(true, std::memory_order_acq_rel))
+                {
+                    state->promise.set_exception(future->get_exception());
+                }
+            }
+            else
+            {
+                state->values.store(i, *future);
+            }
+
+            if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1 &&
+                !state->is_complete.exchange(true, std::memory_order_acq_rel))
+            {
+                state->values.complete(state->promise);
+            }
+        });
+    }
+
+    return result;
+}
+
+/**
+* Value produced by when_any(): the index and the value of the first ready future, the index for void
+*/
+template <typename T>
+struct WhenAnyValue
+{
+    using result_t = std::pair<size_t, T>;
+
+    static void complete(Promise<result_t>& promise, size_t index, const FutureState<T>& state)
+    {
+        promise.set_value(std::make_pair(index, state.get()));
+    }
+};
+
+template <>
+struct WhenAnyValue<void>
+{
+    using result_t = size_t;
+
+    static void complete(Promise<result_t>& promise, size_t index, const FutureState<void>&)
+    {
+        promise.set_value(index);
+    }
+};
+
+/**
+* @return a future that is ready once any of the futures is ready, with its index and value, or with
+* its exception
+*
+* The returned future fails with std::future_errc::broken_promise if the vector is empty.
+*/
+template <typename T>
+Future<typename WhenAnyValue<T>::result_t> when_any(const std::vector<Future<T>>& futures)
+{
+    using result_t = typename WhenAnyValue<T>::result_t;
+
+    struct any_state_t
+    {
+        Promise<result_t> promise;
+        std::atomic<bool> is_complete{false};
+    };
+
+    const auto state = std::make_shared<any_state_t>();
+    auto result = state->promise.get_future();
+
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        futures[i].notify([state, i](const std::shared_ptr<FutureState<T>>& future)
+        {
+            if (!state->is_complete.exchange(true, std::memory_order_acq_rel))
+            {
+                if (future->has_exception())
+                {
+                    state->promise.set_exception(future->get_exception());
+                }
+                else
+                {
+                    WhenAnyValue<T>::complete(state->promise, i, *future);
+                }
+            }
+        });
+    }
+
+    return result;
+}
+
+}
+
+#endif
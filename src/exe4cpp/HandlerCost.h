@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_HANDLERCOST_H
+#define EXE4CPP_HANDLERCOST_H
+
+#include "exe4cpp/Typedefs.h"
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace exe4cpp
+{
+
+/// @return the virtual time taken by the next handler, given its tag, empty if it was not tagged
+using cost_model_t = std::function<duration_t(const std::string& tag)>;
+
+/**
+* Models of the virtual time taken by handlers, for MockExecutor::set_cost_model() and Simulation.
+*
+* Any cost_model_t can be used, these cover the usual cases. Except for by_tag(), they charge every
+* handler alike whatever its tag. The sampled models own their random engine, seeded explicitly so
+* that a simulation is reproducible. A copy of a model continues the same sequence of samples
+* independently of the original.
+*/
+struct HandlerCost
+{
+    /// every handler takes the same time
+    static cost_model_t fixed(const duration_t& cost)
+    {
+        return [cost](const std::string&)
+        {
+            return cost;
+        };
+    }
+
+    /**
+    * Costs drawn from a distribution of <random>, in units of a duration, e.g. an
+    * std::exponential_distribution<double> with a mean of 1 and a unit of the mean cost. Negative
+    * samples count as zero.
+    */
+    template <typename distribution_t>
+    static cost_model_t sampled(const distribution_t& distribution, const duration_t& unit, uint64_t seed = 0)
+    {
+        return [distribution = distribution_t{distribution}, unit, engine = std::mt19937_64{seed}](const std::string&) mutable
+        {
+            const auto value = distribution(engine);
+            if (value <= 0)
+            {
+                return duration_t::zero();
+            }
+            return std::chrono::duration_cast<duration_t>(unit * static_cast<double>(value));
+        };
+    }
+
+    /// Costs picked uniformly among measured samples, which must not be empty
+    static cost_model_t empirical(const std::vector<duration_t>& samples, uint64_t seed = 0)
+    {
+        std::uniform_int_distribution<size_t> index{0, samples.size() - 1};
+        return [samples, index, engine = std::mt19937_64{seed}](const std::string&) mutable
+        {
+            return samples[index(engine)];
+        };
+    }
+
+    /// Cost of each handler given by the model of its tag, or by a default model, no cost if null
+    static cost_model_t by_tag(const std::unordered_map<std::string, cost_model_t>& models, const cost_model_t& other = nullptr)
+    {
+        return [models, other](const std::string& tag) mutable
+        {
+            const auto iter = models.find(tag);
+            if (iter != models.end())
+            {
+                return iter->second(tag);
+            }
+            return other ? other(tag) : duration_t::zero();
+        };
+    }
+};
+
+}
+
+#endif
@@ -26,6 +26,7 @@
 #define EXE4CPP_IEXECUTOR_H
 
 #include "exe4cpp/Timer.h"
+#include "exe4cpp/TimerSlack.h"
 #include "exe4cpp/ISteadyTimeSource.h"
 
 /**
@@ -53,6 +54,17 @@ public:
     /// @return start a new timer based on an absolute timestamp of the steady clock
     virtual Timer start(const steady_time_t& expiration, const action_t& action) = 0;
 
+    /**
+    * @return start a new timer that may fire up to slack after the duration, so that timers
+    * whose windows overlap can be coalesced into a single wakeup (see TimerSlack)
+    *
+    * The default implementation aligns the expiration, executors may also group the timers.
+    */
+    virtual Timer start(const duration_t& duration, const action_t& action, const duration_t& slack)
+    {
+        return this->start(TimerSlack::align(this->get_time() + duration, slack), action);
+    }
+
     /// @return Thread-safe way to post an event to be handled asynchronously
     virtual void post(const action_t& action) = 0;
 };
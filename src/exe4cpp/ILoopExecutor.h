@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_ILOOPEXECUTOR_H
+#define EXE4CPP_ILOOPEXECUTOR_H
+
+#include "exe4cpp/IExecutor.h"
+
+#include <cstddef>
+
+namespace exe4cpp
+{
+
+/**
+ * Executor that owns its event loop, which is driven by the thread calling run() or poll().
+ *
+ * Lets applications pick an event loop backend at runtime (e.g. io_uring or epoll) and drive it
+ * the same way.
+ */
+class ILoopExecutor : public IExecutor
+{
+public:
+
+    virtual ~ILoopExecutor() {}
+
+    /// Run the loop until stop() is called
+    virtual void run() = 0;
+
+    /// Run the handlers that are ready without blocking
+    /// @return the number of handlers that were executed
+    virtual size_t poll() = 0;
+
+    /// Make run() return after the current iteration, can be called from any thread
+    virtual void stop() = 0;
+
+    /// Allow run() to be called again after stop()
+    virtual void restart() = 0;
+};
+
+}
+
+#endif
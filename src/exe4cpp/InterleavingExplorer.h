@@ -0,0 +1,561 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_INTERLEAVINGEXPLORER_H
+#define EXE4CPP_INTERLEAVINGEXPLORER_H
+
+#include "exe4cpp/MockExecutor.h"
+#include "exe4cpp/TimerHeap.h"
+#include "exe4cpp/VirtualClock.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace exe4cpp
+{
+
+/// Index of the strand that runs its next handler, for each step of a run
+using schedule_t = std::vector<size_t>;
+
+/**
+* Outcome of an exploration, see InterleavingExplorer
+*/
+struct ExplorationResult
+{
+    /// number of runs of the scenario, the failing one included
+    size_t num_runs = 0;
+    /// runs abandoned by the reduction because they were equivalent to a previous run
+    size_t num_pruned = 0;
+    /// true if every interleaving was explored, only set by InterleavingExplorer::explore_all()
+    bool is_exhaustive = false;
+
+    /// true if a handler or a check threw
+    bool is_failed = false;
+    /// what() of the exception that failed the run
+    std::string failure;
+    /// steps of the failing run up to the failure, to be given to InterleavingExplorer::replay()
+    schedule_t schedule;
+};
+
+/**
+* One execution of a scenario by an InterleavingExplorer.
+*
+* The scenario creates the strands, posts the first handlers and registers the checks to run at the
+* end. The strands are MockExecutors whose handlers run one at a time, in the order chosen by the
+* explorer. Handlers take no virtual time. When no handler is ready, the clock jumps to the next
+* timer expiration and the timers expiring together are queued in deadline order.
+*/
+class ExplorationRun final : private IMockScheduler
+{
+    friend class InterleavingExplorer;
+
+public:
+    ~ExplorationRun()
+    {
+        while (!this->timers.empty())
+        {
+            const auto timer = this->timers.pop();
+            timer->source->release(timer);
+        }
+        for (auto& strand : this->strands)
+        {
+            strand->scheduler = nullptr;
+        }
+    }
+
+    // Uncopyable
+    ExplorationRun(const ExplorationRun&) = delete;
+    ExplorationRun& operator=(const ExplorationRun&) = delete;
+
+    /// @return a new strand controlled by the explorer, it must not outlive the run
+    std::shared_ptr<MockExecutor> create_strand()
+    {
+        const auto strand = std::make_shared<MockExecutor>(this->clock);
+        strand->scheduler = this;
+        strand->scheduler_index = this->strands.size();
+        this->strands.push_back(strand);
+        return strand;
+    }
+
+    /**
+    * Declare that the running handler uses some state shared with the handlers of other strands.
+    *
+    * Only needed with the reduction enabled: handlers of different strands that neither touch the
+    * same resource, nor post to the same strand, nor start or cancel timers are assumed to commute.
+    */
+    void touch(const std::string& resource)
+    {
+        if (this->is_stepping)
+        {
+            add_unique(this->footprint.resources, resource);
+        }
+    }
+
+    /// Run a check once no handler is left to run, the run fails if it throws
+    void add_check(const action_t& check)
+    {
+        this->checks.push_back(check);
+    }
+
+    size_t num_strands() const
+    {
+        return this->strands.size();
+    }
+
+    steady_time_t get_time() const
+    {
+        return this->clock->get_time();
+    }
+
+private:
+    // what a step did that may not commute with the steps of other strands
+    struct Footprint
+    {
+        std::vector<size_t> strands;
+        std::vector<std::string> resources;
+        bool timers = false;
+
+        bool is_independent(const Footprint& other) const
+        {
+            return !(this->timers && other.timers) &&
+                   !intersects(this->strands, other.strands) &&
+                   !intersects(this->resources, other.resources);
+        }
+    };
+
+    ExplorationRun() : clock{VirtualClock::create()}
+    {}
+
+    template <typename T>
+    static void add_unique(std::vector<T>& values, const T& value)
+    {
+        if (std::find(values.begin(), values.end(), value) == values.end())
+        {
+            values.push_back(value);
+        }
+    }
+
+    template <typename T>
+    static bool intersects(const std::vector<T>& lhs, const std::vector<T>& rhs)
+    {
+        return std::find_first_of(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()) != lhs.end();
+    }
+
+    bool is_enabled(size_t index) const
+    {
+        return index < this->strands.size() && this->strands[index]->num_active() > 0;
+    }
+
+    std::vector<size_t> enabled() const
+    {
+        std::vector<size_t> result;
+        for (size_t i = 0; i < this->strands.size(); ++i)
+        {
+            if (this->is_enabled(i))
+            {
+                result.push_back(i);
+            }
+        }
+        return result;
+    }
+
+    /// expire timers until a handler is ready, @return false if the run is over
+    bool advance()
+    {
+        while (true)
+        {
+            for (size_t i = 0; i < this->strands.size(); ++i)
+            {
+                if (this->is_enabled(i))
+                {
+                    return true;
+                }
+            }
+
+            if (this->timers.empty())
+            {
+                return false;
+            }
+
+            this->clock->advance_to(this->timers.top()->expiration);
+            while (!this->timers.empty() && this->timers.top()->expiration <= this->clock->get_time())
+            {
+                const auto timer = this->timers.pop();
+                timer->source->expire(timer);
+            }
+        }
+    }
+
+    /// run the next handler of a strand, @return false if it threw
+    bool step(size_t index, Footprint& result, std::string& failure)
+    {
+        this->footprint = Footprint{};
+        this->is_stepping = true;
+        const auto is_success = capture(failure, [&]()
+        {
+            this->strands[index]->run_posted();
+        });
+        this->is_stepping = false;
+        result = std::move(this->footprint);
+        return is_success;
+    }
+
+    /// @return false if a check threw
+    bool finish(std::string& failure)
+    {
+        for (const auto& check : this->checks)
+        {
+            if (!capture(failure, check))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename action_type>
+    static bool capture(std::string& failure, const action_type& action)
+    {
+        try
+        {
+            action();
+            return true;
+        }
+        catch (const std::exception& ex)
+        {
+            failure = ex.what();
+        }
+        catch (...)
+        {
+            failure = "unknown exception";
+        }
+        return false;
+    }
+
+    // ---- Implement IMockScheduler -----
+
+    virtual void on_post(MockExecutor& executor) override
+    {
+        if (this->is_stepping)
+        {
+            add_unique(this->footprint.strands, executor.scheduler_index);
+        }
+    }
+
+    virtual void on_start(MockTimer& timer) override
+    {
+        this->timers.push(&timer);
+        this->footprint.timers = this->footprint.timers || this->is_stepping;
+    }
+
+    virtual void on_cancel(MockTimer& timer) override
+    {
+        this->timers.remove(&timer);
+        this->footprint.timers = this->footprint.timers || this->is_stepping;
+    }
+
+    const std::shared_ptr<VirtualClock> clock;
+    std::vector<std::shared_ptr<MockExecutor>> strands;
+    std::vector<action_t> checks;
+    TimerHeap<MockTimer> timers;
+
+    bool is_stepping = false;
+    Footprint footprint;
+};
+
+/**
+* Explores the interleavings of the handlers of several strands to find the orderings that break
+* a scenario, e.g. races between sessions that only show up under rare schedules on a ThreadPool.
+*
+* The scenario is run from scratch for each interleaving, on a fresh ExplorationRun, and must
+* behave the same whenever the explorer makes the same choices. A run fails when a handler or a
+* check throws. The schedule of a failing run is returned and can be replayed step by step.
+*
+* explore_all() enumerates the interleavings depth-first. With the reduction enabled, it uses sleep
+* sets to skip the interleavings that only reorder independent handlers (see ExplorationRun::touch()),
+* which still reaches every distinct outcome. explore_random() samples interleavings with a seeded
+* generator, so the same seed explores the same schedules.
+*/
+class InterleavingExplorer final
+{
+public:
+    using scenario_t = std::function<void(ExplorationRun&)>;
+
+    /// Skip the interleavings that only reorder independent handlers, off by default
+    void set_reduction(bool enabled)
+    {
+        this->use_reduction = enabled;
+    }
+
+    /// Stop each run after some number of handlers, e.g. for scenarios that never become idle
+    void set_max_steps(size_t max_steps)
+    {
+        this->max_steps = max_steps;
+    }
+
+    /// Run the scenario under every interleaving, up to a maximum number of runs, stopping at the first failure
+    ExplorationResult explore_all(const scenario_t& scenario, size_t max_runs = std::numeric_limits<size_t>::max())
+    {
+        ExplorationResult result;
+        std::vector<Node> stack;
+
+        while (result.num_runs < max_runs)
+        {
+            ++result.num_runs;
+
+            ExplorationRun run;
+            if (!ExplorationRun::capture(result.failure, [&]() { scenario(run); }))
+            {
+                result.is_failed = true;
+                return result;
+            }
+
+            bool is_pruned = false;
+            std::vector<Step> sleep;
+
+            for (size_t depth = 0; depth < this->max_steps && run.advance(); ++depth)
+            {
+                if (depth == stack.size())
+                {
+                    Node node;
+                    node.enabled = run.enabled();
+                    const auto choice = std::find_if(node.enabled.begin(), node.enabled.end(), [&](size_t index)
+                    {
+                        return !contains(sleep, index);
+                    });
+                    if (choice == node.enabled.end())
+                    {
+                        // every continuation was covered by a previous run
+                        is_pruned = true;
+                        break;
+                    }
+                    node.chosen = *choice;
+                    stack.push_back(std::move(node));
+                }
+                else if (!run.is_enabled(stack[depth].chosen))
+                {
+                    throw std::logic_error("scenario is not deterministic");
+                }
+
+                auto& node = stack[depth];
+                node.sleep = std::move(sleep);
+                result.schedule.push_back(node.chosen);
+
+                if (!run.step(node.chosen, node.footprint, result.failure))
+                {
+                    result.is_failed = true;
+                    return result;
+                }
+
+                // the handlers asleep at this node stay asleep as long as they commute with the chosen one
+                sleep.clear();
+                if (this->use_reduction)
+                {
+                    for (const auto* steps : { &node.sleep, &node.done })
+                    {
+                        for (const auto& step : *steps)
+                        {
+                            if (step.footprint.is_independent(node.footprint))
+                            {
+                                sleep.push_back(step);
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (is_pruned)
+            {
+                ++result.num_pruned;
+            }
+            else if (!run.finish(result.failure))
+            {
+                result.is_failed = true;
+                return result;
+            }
+
+            result.schedule.clear();
+            if (!backtrack(stack))
+            {
+                result.is_exhaustive = true;
+                return result;
+            }
+        }
+
+        return result;
+    }
+
+    /// Run the scenario under random interleavings, stopping at the first failure
+    ExplorationResult explore_random(const scenario_t& scenario, size_t num_runs, uint64_t seed)
+    {
+        ExplorationResult result;
+        std::mt19937_64 generator{seed};
+
+        while (result.num_runs < num_runs)
+        {
+            ++result.num_runs;
+            result.schedule.clear();
+
+            const auto choose = [&generator](const std::vector<size_t>& enabled)
+            {
+                return enabled[std::uniform_int_distribution<size_t>{0, enabled.size() - 1}(generator)];
+            };
+
+            if (!this->execute(scenario, choose, result))
+            {
+                return result;
+            }
+        }
+
+        result.schedule.clear();
+        return result;
+    }
+
+    /**
+    * Run the scenario once, following a schedule. Once the schedule is exhausted, the strand with
+    * the lowest index that has a handler ready runs next.
+    */
+    ExplorationResult replay(const scenario_t& scenario, const schedule_t& schedule)
+    {
+        ExplorationResult result;
+        result.num_runs = 1;
+
+        const auto choose = [&](const std::vector<size_t>& enabled)
+        {
+            const auto step = result.schedule.size();
+            if (step >= schedule.size())
+            {
+                return enabled.front();
+            }
+            if (std::find(enabled.begin(), enabled.end(), schedule[step]) == enabled.end())
+            {
+                throw std::logic_error("schedule does not match the scenario");
+            }
+            return schedule[step];
+        };
+
+        if (this->execute(scenario, choose, result))
+        {
+            result.schedule.clear();
+        }
+        return result;
+    }
+
+private:
+    using Footprint = ExplorationRun::Footprint;
+
+    struct Step
+    {
+        size_t strand;
+        Footprint footprint;
+    };
+
+    // a choice point of the depth-first exploration
+    struct Node
+    {
+        std::vector<size_t> enabled;
+        size_t chosen = 0;
+        // footprint of the chosen handler in the current run
+        Footprint footprint;
+        // handlers already explored from this node
+        std::vector<Step> done;
+        // handlers that need not be explored from this node
+        std::vector<Step> sleep;
+    };
+
+    static bool contains(const std::vector<Step>& steps, size_t strand)
+    {
+        return std::any_of(steps.begin(), steps.end(), [strand](const Step& step)
+        {
+            return step.strand == strand;
+        });
+    }
+
+    /// move to the next unexplored choice, @return false once every choice was explored
+    static bool backtrack(std::vector<Node>& stack)
+    {
+        while (!stack.empty())
+        {
+            auto& node = stack.back();
+            node.done.push_back(Step{node.chosen, node.footprint});
+
+            for (const auto index : node.enabled)
+            {
+                if (!contains(node.done, index) && !contains(node.sleep, index))
+                {
+                    node.chosen = index;
+                    return true;
+                }
+            }
+
+            stack.pop_back();
+        }
+        return false;
+    }
+
+    /// run the scenario once with a choice function, @return false if the run failed
+    template <typename choose_t>
+    bool execute(const scenario_t& scenario, const choose_t& choose, ExplorationResult& result)
+    {
+        ExplorationRun run;
+        if (!ExplorationRun::capture(result.failure, [&]() { scenario(run); }))
+        {
+            result.is_failed = true;
+            return false;
+        }
+
+        Footprint footprint;
+        for (size_t depth = 0; depth < this->max_steps && run.advance(); ++depth)
+        {
+            const auto index = choose(run.enabled());
+            result.schedule.push_back(index);
+            if (!run.step(index, footprint, result.failure))
+            {
+                result.is_failed = true;
+                return false;
+            }
+        }
+
+        if (!run.finish(result.failure))
+        {
+            result.is_failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    bool use_reduction = false;
+    size_t max_steps = 100000;
+};
+
+}
+
+#endif
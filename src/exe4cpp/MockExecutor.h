@@ -25,76 +25,163 @@
 #ifndef EXE4CPP_MOCKEXECUTOR_H
 #define EXE4CPP_MOCKEXECUTOR_H
 
+#include "exe4cpp/HandlerCost.h"
 #include "exe4cpp/IExecutor.h"
+#include "exe4cpp/TimerHeap.h"
+#include "exe4cpp/VirtualClock.h"
 
-#include <algorithm>
 #include <cstddef>
 #include <limits>
 #include <memory>
 #include <queue>
+#include <string>
 
 namespace exe4cpp
 {
 
+class MockExecutor;
+
 /**
-* Mock implementation of IExecutor for testing
+* Timer of a MockExecutor. The node is in the heap of its executor, or of the Simulation or
+* ExplorationRun driving the executor.
 */
-class MockExecutor final : public IExecutor
+class MockTimer final : public ITimer, public TimerHeapNode
 {
-private:
-    class MockTimer final : public ITimer
+    friend class ExplorationRun;
+    friend class MockExecutor;
+    friend class Simulation;
+
+public:
+    MockTimer(MockExecutor* source, const steady_time_t& time, const std::string& tag, const action_t& action) :
+            source{source},
+            tag{tag},
+            action{action}
     {
-        friend class MockExecutor;
+        this->expiration = time;
+    }
 
-    public:
-        MockTimer(MockExecutor* source, const steady_time_t& time, const action_t& action) :
-                time{time},
-                source{source},
-                action{action}
-        {}
+    // implement ITimer
+    void cancel() override;
 
-        // implement ITimer
-        void cancel() override
-        {
-            source->cancel(this);
-        }
+    steady_time_t expires_at() override
+    {
+        return this->expiration;
+    }
 
-        steady_time_t expires_at() override
-        {
-            return this->time;
-        }
+private:
+    MockExecutor* source;
+    std::string tag;
+    action_t action;
+    // keeps the timer alive while it is pending
+    std::shared_ptr<MockTimer> self;
+};
 
-    private:
-        steady_time_t time;
-        MockExecutor* source;
-        action_t action;
-    };
+/**
+* Receives the posts and timers of the MockExecutors it schedules, see Simulation and ExplorationRun
+*/
+class IMockScheduler
+{
+public:
+    virtual ~IMockScheduler() = default;
+
+    /// an action was queued by the executor
+    virtual void on_post(MockExecutor& executor) = 0;
+    /// a timer was started by the executor
+    virtual void on_start(MockTimer& timer) = 0;
+    /// a timer that was not expired yet was canceled
+    virtual void on_cancel(MockTimer& timer) = 0;
+};
+
+/**
+* Mock implementation of IExecutor for testing
+*
+* The executor reads the time of a VirtualClock, its own unless one is given to share with other
+* executors. The executors created by a Simulation or an ExplorationRun are driven by it: their timers
+* expire when it says so and their run_one(), advance_time() etc. must not be used.
+*
+* Handlers run in zero virtual time unless a cost model is set, in which case the clock advances by
+* the cost of each handler after it has run. The tagged post() and start() overloads name the
+* handler for the cost model, the IExecutor ones leave its tag empty.
+*
+* Pending timers are kept in a TimerHeap, so run_until() and run_until_idle() jump the clock from
+* one expiration to the next without scanning the timers, whatever their number.
+*/
+class MockExecutor final : public IExecutor
+{
+    friend class ExplorationRun;
+    friend class MockTimer;
+    friend class Simulation;
 
 public:
-    MockExecutor() = default;
+    explicit MockExecutor(const std::shared_ptr<VirtualClock>& clock = nullptr) :
+        clock{clock ? clock : VirtualClock::create()}
+    {}
+
+    ~MockExecutor()
+    {
+        while (!this->timers.empty())
+        {
+            this->release(this->timers.pop());
+        }
+    }
 
     // ------ Implement IExecutor ------
 
+    using IExecutor::start;
+
     virtual Timer start(const duration_t& delay, const action_t& action) override
     {
-        return start(current_time + delay, action);
+        return start(this->get_time() + delay, action);
     }
 
     virtual Timer start(const steady_time_t& time, const action_t& action) override
     {
-        const auto timer = std::make_shared<MockTimer>(this, time, action);
-        this->timers.push_back(timer);
-        return Timer{timer};
+        return this->start(time, std::string{}, action);
     }
 
     virtual void post(const action_t& action) override
     {
-        this->post_queue.push_back(action);
+        this->post(std::string{}, action);
+    }
+
+    /// Start a timer whose handler is charged the cost of a tag
+    Timer start(const duration_t& delay, const std::string& tag, const action_t& action)
+    {
+        return this->start(this->get_time() + delay, tag, action);
+    }
+
+    /// Start a timer whose handler is charged the cost of a tag
+    Timer start(const steady_time_t& time, const std::string& tag, const action_t& action)
+    {
+        const auto timer = std::make_shared<MockTimer>(this, time, tag, action);
+        timer->self = timer;
+        ++this->num_pending_timers_;
+        if (this->scheduler)
+        {
+            this->scheduler->on_start(*timer);
+        }
+        else
+        {
+            this->timers.push(timer.get());
+        }
+        return Timer{timer};
+    }
+
+    /// Post an action charged the cost of a tag
+    void post(const std::string& tag, const action_t& action)
+    {
+        this->enqueue(Queued{tag, action});
     }
 
     virtual steady_time_t get_time() override
     {
-        return current_time;
+        return this->clock->get_time();
+    }
+
+    /// @return the clock read by this executor
+    const std::shared_ptr<VirtualClock>& get_clock() const
+    {
+        return this->clock;
     }
 
     /**	@return true if an action was run. */
@@ -102,17 +189,22 @@ public:
     {
         this->check_for_expired_timers();
 
-        if (this->post_queue.size() > 0)
+        if (!this->run_posted())
         {
-            auto runnable = post_queue.front();
-            this->post_queue.pop_front();
-            runnable();
-            return true;
+            return false;
         }
-        else
+
+        if (this->cost_model)
         {
-            return false;
+            this->clock->advance(this->cost_model(this->running_tag));
         }
+        return true;
+    }
+
+    /// Charge the virtual time of a model to each handler, no cost if null. Also used by a Simulation.
+    void set_cost_model(const cost_model_t& model)
+    {
+        this->cost_model = model;
     }
 
     /** Calls RunOne() up to some maximum number of times continuing while
@@ -135,40 +227,30 @@ public:
 
     size_t num_pending_timers() const
     {
-        return this->timers.size();
+        return this->num_pending_timers_;
     }
 
     steady_time_t next_timer_expiration_abs() const
     {
-        auto lt = [](const std::shared_ptr<MockTimer>& lhs, const std::shared_ptr<MockTimer>& rhs)
-        {
-            return lhs->expires_at() < rhs->expires_at();
-        };
-        auto min = std::min_element(this->timers.begin(), this->timers.end(), lt);
-        if (min == this->timers.end())
+        if (this->timers.empty())
         {
             return steady_time_t();
         }
         else
         {
-            return (*min)->expires_at();
+            return this->timers.top()->expiration;
         }
     }
 
     duration_t next_timer_expiration_rel() const
     {
-        auto lt = [](const std::shared_ptr<MockTimer>& lhs, const std::shared_ptr<MockTimer>& rhs)
-        {
-            return lhs->expires_at() < rhs->expires_at();
-        };
-        auto min = std::min_element(this->timers.begin(), this->timers.end(), lt);
-        if (min == this->timers.end())
+        if (this->timers.empty())
         {
             return duration_t::max();
         }
         else
         {
-            return (*min)->expires_at() - this->current_time;
+            return this->timers.top()->expiration - this->clock->get_time();
         }
     }
 
@@ -181,7 +263,7 @@ public:
     // doesn't check timers_
     void add_time(duration_t duration)
     {
-        this->current_time += duration;
+        this->clock->advance(duration);
     }
 
     bool advance_to_next_timer()
@@ -192,11 +274,11 @@ public:
         }
         else
         {
-            const  auto timestamp = next_timer_expiration_abs();
+            const auto timestamp = next_timer_expiration_abs();
 
-            if (timestamp > this->current_time)
+            if (timestamp > this->clock->get_time())
             {
-                this->current_time = timestamp;
+                this->clock->advance_to(timestamp);
                 return true;
             }
             else
@@ -206,69 +288,161 @@ public:
         }
     }
 
+    /**
+    * Run the handlers and expire the timers in time order until a time, jumping the clock from
+    * one expiration to the next, then move the clock to that time
+    *
+    * @return the number of handlers run
+    */
+    size_t run_until(const steady_time_t& time)
+    {
+        size_t count = this->run_many();
+        while (!this->timers.empty() && this->timers.top()->expiration <= time)
+        {
+            this->clock->advance_to(this->timers.top()->expiration);
+            count += this->run_many();
+        }
+        this->clock->advance_to(time);
+        return count;
+    }
+
+    /**
+    * Run until no handler is queued and no timer is pending, the clock is left at the last
+    * expiration. Never returns if timers keep being restarted, use run_until() for such scenarios.
+    *
+    * @return the number of handlers run
+    */
+    size_t run_until_idle()
+    {
+        size_t count = this->run_many();
+        while (!this->timers.empty())
+        {
+            this->clock->advance_to(this->timers.top()->expiration);
+            count += this->run_many();
+        }
+        return count;
+    }
+
     size_t num_timer_cancel() const
     {
         return this->num_timer_cancel_;
     }
 
 private:
+    struct Queued
+    {
+        std::string tag;
+        action_t action;
+    };
+
+    typedef std::deque<Queued> post_queue_t;
+
+    void enqueue(Queued&& queued)
+    {
+        this->post_queue.push_back(std::move(queued));
+        if (this->scheduler)
+        {
+            this->scheduler->on_post(*this);
+        }
+    }
+
+    bool run_posted()
+    {
+        if (this->post_queue.empty())
+        {
+            return false;
+        }
+
+        auto runnable = std::move(this->post_queue.front());
+        this->post_queue.pop_front();
+        // read by the cost model once the handler has run
+        this->running_tag = std::move(runnable.tag);
+        runnable.action();
+        return true;
+    }
+
     size_t check_for_expired_timers()
     {
+        // the scheduler expires the timers
+        if (this->scheduler)
+        {
+            return 0;
+        }
+
+        // the heap pops the expired timers in deadline order, ties in start order
+        const auto now = this->clock->get_time();
         size_t count = 0;
-        while (find_expired_timer())
+        while (!this->timers.empty() && this->timers.top()->expiration <= now)
         {
+            this->post_queue.push_back(this->take(this->timers.pop()));
             ++count;
         }
         return count;
     }
 
-    bool find_expired_timer()
+    /// @return the action of an expired timer, which keeps the timer alive until its callback is completed
+    Queued take(MockTimer* timer)
     {
-        auto expired = [this](const std::shared_ptr<MockTimer>& timer)
-        {
-            return timer->expires_at() <= this->current_time;
-        };
+        --this->num_pending_timers_;
+        return Queued{timer->tag, [timer = std::move(timer->self)]() -> void { timer->action(); }};
+    }
+
+    /// drop the ownership of a pending timer, e.g. when its executor or scheduler goes away
+    void release(MockTimer* timer)
+    {
+        --this->num_pending_timers_;
+        const auto self = std::move(timer->self);
+    }
 
-        auto iter = std::find_if(this->timers.begin(), this->timers.end(), expired);
+    void cancel(MockTimer* timer)
+    {
+        if (!timer->self)
+        {
+            return;
+        }
 
-        if (iter == this->timers.end())
+        ++num_timer_cancel_;
+        if (this->scheduler)
         {
-            return false;
+            this->scheduler->on_cancel(*timer);
         }
         else
         {
-            // keep the timer alive until it's callback is completed.
-            auto action = [timer = (*iter), action = (*iter)->action]() -> void { action(); };
-            this->post_queue.push_back(action);
-            this->timers.erase(iter);
-            return true;
+            this->timers.remove(timer);
         }
+        this->release(timer);
     }
 
-    void cancel(ITimer* timer)
+    /// queue the action of a timer the scheduler has expired
+    void expire(MockTimer* timer)
     {
-        const auto result = std::find_if(this->timers.begin(), this->timers.end(), [timer](const std::shared_ptr<MockTimer>& item)
-        {
-            return item.get() == timer;
-        });
-
-        if (result != this->timers.end())
+        if (timer->self)
         {
-            ++num_timer_cancel_;
-            this->timers.erase(result);
+            this->enqueue(this->take(timer));
         }
     }
 
-    typedef std::deque<action_t> post_queue_t;
-    typedef std::vector<std::shared_ptr<MockTimer>> timer_vector_t;
-
-    steady_time_t current_time;
+    const std::shared_ptr<VirtualClock> clock;
     size_t num_timer_cancel_ = 0;
 
     post_queue_t post_queue;
-    timer_vector_t timers;
+    TimerHeap<MockTimer> timers;
+    size_t num_pending_timers_ = 0;
+
+    cost_model_t cost_model;
+    // tag of the last handler run
+    std::string running_tag;
+
+    // set by the Simulation or ExplorationRun that owns the executor
+    IMockScheduler* scheduler = nullptr;
+    size_t scheduler_index = 0;
 };
 
+inline void MockTimer::cancel()
+{
+    source->cancel(this);
+}
+
 }
 
 #endif
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_ORDEREDPROCESSOR_H
+#define EXE4CPP_ORDEREDPROCESSOR_H
+
+#include "exe4cpp/IExecutor.h"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+
+namespace exe4cpp
+{
+
+/**
+* Processes items in parallel and delivers the results in submission order.
+*
+* Each submitted item gets a sequence number and is transformed on the worker executor (typically a
+* BasicExecutor whose io_service is run by a ThreadPool). Completed results are stored in a fixed size
+* reorder buffer and handed to the sink on the target executor (typically a StrandExecutor) strictly in
+* sequence order. The buffer is lock-free: workers publish their slot with an atomic flag and only the
+* completion that finds the target idle posts a drain.
+*
+* The window size caps the number of items in flight. submit() returns false when the window is full,
+* in which case the producer should retry after the sink has consumed some results.
+*
+* An exception thrown by the transform fills the slot of the item in place of its result, so that the
+* items behind it are still delivered. It is handed to the optional error sink, in sequence order on
+* the target executor, and the item is dropped if there is none. An exception thrown by a sink
+* propagates to the target executor, after the results behind its item are scheduled for delivery.
+*
+* submit() must be called from a single producer at a time. output_t must be default constructible.
+*/
+template <typename input_t, typename output_t>
+class OrderedProcessor final : public std::enable_shared_from_this<OrderedProcessor<input_t, output_t>>
+{
+public:
+    using transform_t = std::function<output_t(input_t&)>;
+    using sink_t = std::function<void(output_t&&)>;
+    using error_sink_t = std::function<void(std::exception_ptr)>;
+
+    OrderedProcessor(
+        const std::shared_ptr<IExecutor>& workers,
+        const std::shared_ptr<IExecutor>& target,
+        size_t window,
+        const transform_t& transform,
+        const sink_t& sink,
+        const error_sink_t& on_error = nullptr
+    ) : workers{workers},
+        target{target},
+        window{window == 0 ? 1 : window},
+        transform{transform},
+        sink{sink},
+        on_error{on_error},
+        slots{new slot_t[this->window]}
+    {}
+
+    // Uncopyable
+    OrderedProcessor(const OrderedProcessor&) = delete;
+    OrderedProcessor& operator=(const OrderedProcessor&) = delete;
+
+    static std::shared_ptr<OrderedProcessor> create(
+        const std::shared_ptr<IExecutor>& workers,
+        const std::shared_ptr<IExecutor>& target,
+        size_t window,
+        const transform_t& transform,
+        const sink_t& sink,
+        const error_sink_t& on_error = nullptr
+    )
+    {
+        return std::make_shared<OrderedProcessor>(workers, target, window, transform, sink, on_error);
+    }
+
+    /// @return true if the item was accepted, false if the window is full
+    bool submit(const input_t& input)
+    {
+        const auto seq = this->next_seq.load(std::memory_order_relaxed);
+        if (seq - this->delivered.load(std::memory_order_acquire) >= this->window)
+        {
+            return false;
+        }
+
+        this->next_seq.store(seq + 1, std::memory_order_relaxed);
+
+        auto process = [self = this->shared_from_this(), seq, input = input]() mutable
+        {
+            self->process(seq, input);
+        };
+        this->workers->post(process);
+
+        return true;
+    }
+
+    /// @return the number of items submitted but not yet delivered to the sink
+    size_t num_in_flight() const
+    {
+        return this->next_seq.load(std::memory_order_relaxed) - this->delivered.load(std::memory_order_acquire);
+    }
+
+    size_t window_size() const
+    {
+        return this->window;
+    }
+
+private:
+    struct slot_t
+    {
+        std::atomic<bool> ready{false};
+        output_t value;
+        // set instead of the value if the transform threw
+        std::exception_ptr error;
+    };
+
+    void process(size_t seq, input_t& input)
+    {
+        output_t output{};
+        std::exception_ptr error;
+        try
+        {
+            output = this->transform(input);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        this->complete(seq, std::move(output), std::move(error));
+    }
+
+    void complete(size_t seq, output_t&& value, std::exception_ptr&& error)
+    {
+        auto& slot = this->slots[seq % this->window];
+        slot.value = std::move(value);
+        slot.error = std::move(error);
+        slot.ready.store(true, std::memory_order_release);
+
+        // only the completion that finds the target idle schedules a drain
+        if (this->drain_requests.fetch_add(1, std::memory_order_acq_rel) == 0)
+        {
+            this->schedule_drain();
+        }
+    }
+
+    void schedule_drain()
+    {
+        this->target->post([self = this->shared_from_this()]() { self->drain(); });
+    }
+
+    void drain()
+    {
+        auto requests = this->drain_requests.load(std::memory_order_acquire);
+
+        while (true)
+        {
+            auto seq = this->delivered.load(std::memory_order_relaxed);
+            auto* slot = &this->slots[seq % this->window];
+            while (slot->ready.load(std::memory_order_acquire))
+            {
+                auto value = std::move(slot->value);
+                auto error = std::move(slot->error);
+                slot->value = output_t{};
+                slot->error = nullptr;
+                slot->ready.store(false, std::memory_order_relaxed);
+                // releasing the slot lets the producer reuse it
+                this->delivered.store(++seq, std::memory_order_release);
+
+                try
+                {
+                    if (!error)
+                    {
+                        this->sink(std::move(value));
+                    }
+                    else if (this->on_error)
+                    {
+                        this->on_error(std::move(error));
+                    }
+                }
+                catch (...)
+                {
+                    // the requests are still counted, the next drain takes them over
+                    this->schedule_drain();
+                    throw;
+                }
+
+                slot = &this->slots[seq % this->window];
+            }
+
+            // completions that raced with this drain are picked up by another pass
+            const auto remaining = this->drain_requests.fetch_sub(requests, std::memory_order_acq_rel) - requests;
+            if (remaining == 0)
+            {
+                return;
+            }
+            requests = remaining;
+        }
+    }
+
+    const std::shared_ptr<IExecutor> workers;
+    const std::shared_ptr<IExecutor> target;
+    const size_t window;
+    const transform_t transform;
+    const sink_t sink;
+    const error_sink_t on_error;
+
+    const std::unique_ptr<slot_t[]> slots;
+    std::atomic<size_t> next_seq{0};
+    std::atomic<size_t> delivered{0};
+    std::atomic<size_t> drain_requests{0};
+};
+
+}
+
+#endif
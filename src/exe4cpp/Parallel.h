@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_PARALLEL_H
+#define EXE4CPP_PARALLEL_H
+
+#include "exe4cpp/IExecutor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace exe4cpp
+{
+
+/**
+* Executor on which the chunks of a parallel algorithm run, and how many of them may run at once.
+*
+* Typically a BasicExecutor on an io_service run by a ThreadPool, with the number of threads of the pool.
+*/
+struct ParallelWorkers
+{
+    std::shared_ptr<IExecutor> executor;
+    size_t concurrency;
+    /// smallest number of indices processed by a chunk
+    size_t min_grain_size = 1;
+};
+
+/**
+* Splits an index range into chunks claimed by the workers with an atomic cursor.
+*
+* Chunks are guided: each one is a fraction of what is left, so they start large to keep the
+* scheduling overhead low and shrink towards the end so that faster workers balance the load.
+*/
+class ChunkedRange final
+{
+public:
+    ChunkedRange(size_t begin, size_t end, size_t concurrency, size_t min_grain_size) :
+        end{end},
+        divisor{2 * std::max<size_t>(concurrency, 1)},
+        min_grain_size{std::max<size_t>(min_grain_size, 1)},
+        cursor{begin}
+    {}
+
+    /// @return false once the whole range has been claimed
+    bool claim(size_t& chunk_begin, size_t& chunk_end)
+    {
+        auto current = this->cursor.load(std::memory_order_relaxed);
+        while (current < this->end)
+        {
+            const auto remaining = this->end - current;
+            const auto grain = std::min(remaining, std::max(this->min_grain_size, remaining / this->divisor));
+            if (this->cursor.compare_exchange_weak(current, current + grain, std::memory_order_relaxed))
+            {
+                chunk_begin = current;
+                chunk_end = current + grain;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    const size_t end;
+    const size_t divisor;
+    const size_t min_grain_size;
+    std::atomic<size_t> cursor;
+};
+
+/// @return the number of chunks that run concurrently, never more than the number of minimum size chunks
+inline size_t num_parallel_runners(const ParallelWorkers& workers, size_t begin, size_t end)
+{
+    const auto grain = std::max<size_t>(workers.min_grain_size, 1);
+    const auto max_chunks = (end - begin + grain - 1) / grain;
+    return std::max<size_t>(1, std::min(std::max<size_t>(workers.concurrency, 1), max_chunks));
+}
+
+/**
+* Runs body(worker, begin, end) for every chunk of the range on the workers and calls finish()
+* exactly once, on the worker that completes last. Used by the parallel algorithms below.
+*/
+template <typename body_t, typename finish_t>
+class ParallelRun final
+{
+public:
+    ParallelRun(size_t begin, size_t end, size_t num_runners, size_t min_grain_size, const body_t& body, const finish_t& finish) :
+        range{begin, end, num_runners, min_grain_size},
+        body{body},
+        finish{finish},
+        remaining{num_runners}
+    {}
+
+    // Uncopyable
+    ParallelRun(const ParallelRun&) = delete;
+    ParallelRun& operator=(const ParallelRun&) = delete;
+
+    /// process chunks until the range is exhausted, called once per runner index
+    void execute(size_t runner)
+    {
+        size_t chunk_begin = 0;
+        size_t chunk_end = 0;
+        while (this->range.claim(chunk_begin, chunk_end))
+        {
+            this->body(runner, chunk_begin, chunk_end);
+        }
+
+        if (this->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            this->finish();
+        }
+    }
+
+private:
+    ChunkedRange range;
+    body_t body;
+    finish_t finish;
+    std::atomic<size_t> remaining;
+};
+
+template <typename body_t, typename finish_t>
+void parallel_run(const ParallelWorkers& workers, size_t begin, size_t end, const body_t& body, const finish_t& finish)
+{
+    const auto num_runners = num_parallel_runners(workers, begin, end);
+    const auto run = std::make_shared<ParallelRun<body_t, finish_t>>(begin, end, num_runners, workers.min_grain_size, body, finish);
+    for (size_t i = 0; i < num_runners; ++i)
+    {
+        workers.executor->post([run, i]()
+        {
+            run->execute(i);
+        });
+    }
+}
+
+/**
+* Invoke function(i) for every i in [begin, end) on the workers, then post on_complete to the completion executor
+*
+* The caller never blocks. Anything referenced by the function must outlive the completion.
+*/
+template <typename function_t>
+void parallel_for(
+    const ParallelWorkers& workers,
+    size_t begin,
+    size_t end,
+    const function_t& function,
+    const std::shared_ptr<IExecutor>& completion,
+    const action_t& on_complete
+)
+{
+    if (begin >= end)
+    {
+        completion->post(on_complete);
+        return;
+    }
+
+    auto body = [function](size_t, size_t chunk_begin, size_t chunk_end)
+    {
+        for (auto i = chunk_begin; i < chunk_end; ++i)
+        {
+            function(i);
+        }
+    };
+    auto finish = [completion, on_complete]()
+    {
+        completion->post(on_complete);
+    };
+
+    parallel_run(workers, begin, end, body, finish);
+}
+
+/**
+* Assign *(output + i) = function(*(input + i)) for every element of [input, input_end) on the workers,
+* then post on_complete to the completion executor
+*
+* The iterators must be random access and the ranges must outlive the completion.
+*/
+template <typename input_it_t, typename output_it_t, typename function_t>
+void parallel_transform(
+    const ParallelWorkers& workers,
+    input_it_t input,
+    input_it_t input_end,
+    output_it_t output,
+    const function_t& function,
+    const std::shared_ptr<IExecutor>& completion,
+    const action_t& on_complete
+)
+{
+    const auto count = static_cast<size_t>(std::distance(input, input_end));
+    auto apply = [input, output, function](size_t i)
+    {
+        output[i] = function(input[i]);
+    };
+    parallel_for(workers, 0, count, apply, completion, on_complete);
+}
+
+/**
+* Partial result of a runner of parallel_reduce, and a distinct object even for bool, unlike the
+* elements of a std::vector<bool>.
+*
+* The padding puts the values of two runners a cache line apart, wherever the vector places them, so
+* that runners do not false-share. An over-aligned type is not used, its alignment is not honored by
+* the allocator of std::vector before C++17.
+*/
+template <typename T>
+struct ParallelPartial
+{
+    T value;
+    char pad[63];
+};
+
+/**
+* Reduce map(i) for every i in [begin, end) with combine on the workers, then post the result to the completion executor
+*
+* Each worker reduces the chunks it claims into its own partial result and the worker that completes
+* last combines the partial results. combine must be associative and commutative.
+*/
+template <typename T, typename map_t, typename combine_t>
+void parallel_reduce(
+    const ParallelWorkers& workers,
+    size_t begin,
+    size_t end,
+    const T& identity,
+    const map_t& map,
+    const combine_t& combine,
+    const std::shared_ptr<IExecutor>& completion,
+    const std::function<void(const T&)>& on_result
+)
+{
+    if (begin >= end)
+    {
+        completion->post([on_result, identity]() { on_result(identity); });
+        return;
+    }
+
+    const auto partials = std::make_shared<std::vector<ParallelPartial<T>>>(
+        num_parallel_runners(workers, begin, end),
+        ParallelPartial<T>{identity, {}}
+    );
+
+    auto body = [partials, map, combine](size_t runner, size_t chunk_begin, size_t chunk_end)
+    {
+        auto& partial = (*partials)[runner].value;
+        for (auto i = chunk_begin; i < chunk_end; ++i)
+        {
+            partial = combine(partial, map(i));
+        }
+    };
+    auto finish = [partials, identity, combine, completion, on_result]()
+    {
+        auto result = identity;
+        for (const auto& partial : *partials)
+        {
+            result = combine(result, partial.value);
+        }
+        completion->post([on_result, result]() { on_result(result); });
+    };
+
+    parallel_run(workers, begin, end, body, finish);
+}
+
+}
+
+#endif
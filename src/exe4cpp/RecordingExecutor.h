@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_RECORDINGEXECUTOR_H
+#define EXE4CPP_RECORDINGEXECUTOR_H
+
+#include "exe4cpp/EventLog.h"
+#include "exe4cpp/IExecutor.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace exe4cpp
+{
+
+/**
+* Thread-safe sink of the events of one or more RecordingExecutors.
+*
+* Times are written relative to the first recorded event. The ids of posts and timers are
+* shared by all the executors writing to the recorder.
+*/
+class EventRecorder final
+{
+public:
+    explicit EventRecorder(std::ostream& output) : writer{output}
+    {}
+
+    // Uncopyable
+    EventRecorder(const EventRecorder&) = delete;
+    EventRecorder& operator=(const EventRecorder&) = delete;
+
+    static std::shared_ptr<EventRecorder> create(std::ostream& output)
+    {
+        return std::make_shared<EventRecorder>(output);
+    }
+
+    /// @return the id of the post
+    uint64_t record_post(const steady_time_t& time, const std::string& tag)
+    {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        RecordedEvent event;
+        event.kind = EventKind::post;
+        event.handler = this->writer.intern(tag);
+        return this->write(time, event);
+    }
+
+    /// @return the id of the timer
+    uint64_t record_start(const steady_time_t& time, const steady_time_t& expiration, const std::string& tag)
+    {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        RecordedEvent event;
+        event.kind = EventKind::start;
+        event.handler = this->writer.intern(tag);
+        event.delay = expiration - time;
+        return this->write(time, event);
+    }
+
+    /// Record a cancel, run or complete of a post or timer
+    void record(EventKind kind, const steady_time_t& time, uint64_t id)
+    {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        RecordedEvent event;
+        event.kind = kind;
+        event.id = id;
+        this->write(time, event);
+    }
+
+    void flush()
+    {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        this->writer.flush();
+    }
+
+private:
+    uint64_t write(const steady_time_t& time, RecordedEvent& event)
+    {
+        if (!this->has_origin)
+        {
+            this->origin = time;
+            this->has_origin = true;
+        }
+
+        if (event.kind == EventKind::post || event.kind == EventKind::start)
+        {
+            event.id = this->next_id++;
+        }
+
+        event.time = time - this->origin;
+        this->writer.write(event);
+        return event.id;
+    }
+
+    std::mutex mutex;
+    EventLogWriter writer;
+    bool has_origin = false;
+    steady_time_t origin;
+    uint64_t next_id = 0;
+};
+
+/**
+* Executor that records the posts, timer starts, cancels and handler executions going through
+* another executor (e.g. a StrandExecutor or BasicExecutor) to an EventRecorder.
+*
+* Each post and timer is recorded under a handler tag, e.g. "session.read", which names it in the log
+* and selects the handler that replays it. The tagged post() and start() overloads set it, the
+* IExecutor ones record an empty tag. The log can be read back with EventLogReader and replayed on a
+* MockExecutor by a ReplayDriver.
+* A cancel that races with the expiration of the timer either records the cancel and suppresses
+* the handler, or lets the handler run and does nothing, so the log never holds both.
+*/
+class RecordingExecutor final :
+    public IExecutor,
+    public std::enable_shared_from_this<RecordingExecutor>
+{
+public:
+    RecordingExecutor(const std::shared_ptr<IExecutor>& executor, const std::shared_ptr<EventRecorder>& recorder) :
+        executor{executor},
+        recorder{recorder}
+    {}
+
+    // Uncopyable
+    RecordingExecutor(const RecordingExecutor&) = delete;
+    RecordingExecutor& operator=(const RecordingExecutor&) = delete;
+
+    static std::shared_ptr<RecordingExecutor> create(const std::shared_ptr<IExecutor>& executor, const std::shared_ptr<EventRecorder>& recorder)
+    {
+        return std::make_shared<RecordingExecutor>(executor, recorder);
+    }
+
+    /// Post an action recorded under a handler tag
+    void post(const std::string& tag, const action_t& action)
+    {
+        const auto id = this->recorder->record_post(this->get_time(), tag);
+        this->executor->post([self = shared_from_this(), id, action = action]()
+        {
+            self->run(id, action);
+        });
+    }
+
+    /// Start a timer recorded under a handler tag
+    Timer start(const duration_t& duration, const std::string& tag, const action_t& action)
+    {
+        return this->start(this->get_time() + duration, tag, action);
+    }
+
+    /// Start a timer recorded under a handler tag
+    Timer start(const steady_time_t& expiration, const std::string& tag, const action_t& action)
+    {
+        const auto id = this->recorder->record_start(this->get_time(), expiration, tag);
+        const auto timer = std::make_shared<RecordedTimer>(this->shared_from_this(), id);
+
+        // the callback owns the timer, which lives until the handler has run or the timer is canceled
+        timer->impl = this->executor->start(expiration, [timer, action = action]()
+        {
+            if (!timer->is_finished.exchange(true))
+            {
+                timer->self->run(timer->id, action);
+            }
+        });
+
+        return Timer{timer};
+    }
+
+    // ---- Implement IExecutor -----
+
+    using IExecutor::start;
+
+    virtual Timer start(const duration_t& duration, const action_t& action) override
+    {
+        return this->start(this->get_time() + duration, std::string{}, action);
+    }
+
+    virtual Timer start(const steady_time_t& expiration, const action_t& action) override
+    {
+        return this->start(expiration, std::string{}, action);
+    }
+
+    virtual void post(const action_t& action) override
+    {
+        this->post(std::string{}, action);
+    }
+
+    virtual steady_time_t get_time() override
+    {
+        return this->executor->get_time();
+    }
+
+private:
+    class RecordedTimer final : public ITimer
+    {
+    public:
+        RecordedTimer(const std::shared_ptr<RecordingExecutor>& self, uint64_t id) : self{self}, id{id}
+        {}
+
+        void cancel() override
+        {
+            if (!this->is_finished.exchange(true))
+            {
+                this->self->recorder->record(EventKind::cancel, this->self->get_time(), this->id);
+                this->impl.cancel();
+            }
+        }
+
+        steady_time_t expires_at() override
+        {
+            return this->impl.expires_at();
+        }
+
+        const std::shared_ptr<RecordingExecutor> self;
+        const uint64_t id;
+        Timer impl;
+        std::atomic<bool> is_finished{false};
+    };
+
+    void run(uint64_t id, const action_t& action)
+    {
+        this->recorder->record(EventKind::run, this->get_time(), id);
+        action();
+        this->recorder->record(EventKind::complete, this->get_time(), id);
+    }
+
+    const std::shared_ptr<IExecutor> executor;
+    const std::shared_ptr<EventRecorder> recorder;
+};
+
+}
+
+#endif
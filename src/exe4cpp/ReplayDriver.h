@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_REPLAYDRIVER_H
+#define EXE4CPP_REPLAYDRIVER_H
+
+#include "exe4cpp/EventLog.h"
+#include "exe4cpp/HandlerCost.h"
+#include "exe4cpp/MockExecutor.h"
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace exe4cpp
+{
+
+/**
+* Replays the posts, timer starts and cancels of an EventLog on a MockExecutor.
+*
+* Each post and timer is made at its recorded virtual time, relative to the time of the executor
+* when the replay starts, and runs the handler registered under its recorded tag with the event
+* that made it. Handlers without a registration do nothing. The executor runs the handlers as soon
+* as they are ready, so the replay reproduces the recorded traffic rather than its original
+* queueing. The posts and timers keep their tag on the executor, so the cost model of
+* recorded_costs() charges each handler the execution times recorded for its tag.
+*
+* Virtual time jumps straight to the next event, so a replay also runs recorded traffic shapes at
+* full speed, e.g. as benchmark input for the registered handlers.
+*/
+class ReplayDriver final
+{
+public:
+    using handler_t = std::function<void(const RecordedEvent&)>;
+
+    explicit ReplayDriver(const EventLog& log) : log{log}
+    {}
+
+    /// Run a handler for the posts and timers recorded under a tag, see RecordingExecutor
+    void on_handler(const std::string& tag, const handler_t& handler)
+    {
+        this->handlers[tag] = handler;
+    }
+
+    /// Run a handler for the posts and timers whose tag has no handler of its own
+    void on_other_handlers(const handler_t& handler)
+    {
+        this->default_handler = handler;
+    }
+
+    /**
+    * @return a cost model picking the cost of each handler among the recorded durations of its tag,
+    * see EventLog::durations(), no cost for the tags that never completed a run
+    */
+    cost_model_t recorded_costs(uint64_t seed = 0) const
+    {
+        std::unordered_map<std::string, cost_model_t> models;
+        for (const auto& tag : this->log.handlers)
+        {
+            const auto samples = this->log.durations(tag);
+            if (!samples.empty())
+            {
+                models[tag] = HandlerCost::empirical(samples, seed);
+            }
+        }
+        return HandlerCost::by_tag(models);
+    }
+
+    /// @return the number of handlers run by the executor during the replay
+    size_t replay(MockExecutor& executor)
+    {
+        // resolve the handler of each tag once
+        std::vector<handler_t> resolved;
+        resolved.reserve(this->log.handlers.size());
+        for (const auto& tag : this->log.handlers)
+        {
+            const auto iter = this->handlers.find(tag);
+            resolved.push_back(iter != this->handlers.end() ? iter->second : this->default_handler);
+        }
+
+        const auto base = executor.get_time();
+        std::unordered_map<uint64_t, Timer> timers;
+        size_t num_run = 0;
+
+        for (const auto& event : this->log.events)
+        {
+            switch (event.kind)
+            {
+            case EventKind::post:
+                num_run += executor.run_until(base + event.time);
+                executor.post(this->log.handlers[event.handler], bind(resolved[event.handler], event));
+                break;
+            case EventKind::start:
+                num_run += executor.run_until(base + event.time);
+                timers[event.id] = executor.start(base + event.time + event.delay, this->log.handlers[event.handler], bind(resolved[event.handler], event));
+                break;
+            case EventKind::cancel:
+                {
+                    num_run += executor.run_until(base + event.time);
+                    const auto iter = timers.find(event.id);
+                    if (iter != timers.end())
+                    {
+                        iter->second.cancel();
+                        timers.erase(iter);
+                    }
+                }
+                break;
+            default:
+                // runs and completions are reproduced by the executor
+                break;
+            }
+        }
+
+        return num_run + executor.run_until_idle();
+    }
+
+private:
+    static action_t bind(const handler_t& handler, const RecordedEvent& event)
+    {
+        if (!handler)
+        {
+            return []() {};
+        }
+        return [handler, event]()
+        {
+            handler(event);
+        };
+    }
+
+    const EventLog log;
+    std::unordered_map<std::string, handler_t> handlers;
+    handler_t default_handler;
+};
+
+}
+
+#endif
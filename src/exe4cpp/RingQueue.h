@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_RINGQUEUE_H
+#define EXE4CPP_RINGQUEUE_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace exe4cpp
+{
+
+/**
+* Unbounded FIFO queue stored in a growable ring buffer.
+*
+* Unlike std::deque, which allocates and frees a block every few elements as the queue moves
+* forward, the ring keeps its storage: once it has grown to the high-water mark of the queue,
+* pushing and popping never allocates. The capacity doubles when the ring is full.
+*
+* Not thread-safe. T must be default constructible and move assignable.
+*/
+template <typename T>
+class RingQueue final
+{
+public:
+    explicit RingQueue(size_t initial_capacity = 16) :
+        slots(initial_capacity > 0 ? initial_capacity : 1)
+    {}
+
+    bool empty() const
+    {
+        return this->count == 0;
+    }
+
+    size_t size() const
+    {
+        return this->count;
+    }
+
+    size_t capacity() const
+    {
+        return this->slots.size();
+    }
+
+    void push_back(const T& value)
+    {
+        T copy{value};
+        this->push_back(std::move(copy));
+    }
+
+    void push_back(T&& value)
+    {
+        if (this->count == this->slots.size())
+        {
+            this->grow();
+        }
+
+        this->slots[(this->head + this->count) % this->slots.size()] = std::move(value);
+        ++this->count;
+    }
+
+    T& front()
+    {
+        return this->slots[this->head];
+    }
+
+    /// Removes the front element, the slot is reset so that it does not keep resources alive
+    void pop_front()
+    {
+        this->slots[this->head] = T{};
+        this->head = (this->head + 1) % this->slots.size();
+        --this->count;
+    }
+
+    void swap(RingQueue& other)
+    {
+        this->slots.swap(other.slots);
+        std::swap(this->head, other.head);
+        std::swap(this->count, other.count);
+    }
+
+private:
+    void grow()
+    {
+        std::vector<T> larger(this->slots.size() * 2);
+        for (size_t i = 0; i < this->count; ++i)
+        {
+            larger[i] = std::move(this->slots[(this->head + i) % this->slots.size()]);
+        }
+        this->slots.swap(larger);
+        this->head = 0;
+    }
+
+    std::vector<T> slots;
+    size_t head = 0;
+    size_t count = 0;
+};
+
+}
+
+#endif
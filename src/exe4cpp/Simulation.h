@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_SIMULATION_H
+#define EXE4CPP_SIMULATION_H
+
+#include "exe4cpp/HandlerCost.h"
+#include "exe4cpp/MockExecutor.h"
+#include "exe4cpp/RingQueue.h"
+#include "exe4cpp/TimerHeap.h"
+#include "exe4cpp/VirtualClock.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <vector>
+
+namespace exe4cpp
+{
+
+/**
+* Counters of a Simulation, see Simulation::get_stats()
+*/
+struct SimulationStats
+{
+    /// number of handlers that were run
+    uint64_t num_handlers = 0;
+    /// virtual time charged to the handlers, summed over all the workers
+    duration_t busy_time = duration_t::zero();
+    /// time between the post of the handlers and their start, summed
+    duration_t total_wait = duration_t::zero();
+    /// longest time a handler waited for a worker and its strand
+    duration_t max_wait = duration_t::zero();
+
+    duration_t mean_wait() const
+    {
+        return this->num_handlers ? this->total_wait / static_cast<duration_t::rep>(this->num_handlers) : duration_t::zero();
+    }
+
+    /// @return the fraction of the capacity of the workers that was used over an elapsed time
+    double utilization(const duration_t& elapsed, size_t num_workers) const
+    {
+        const auto capacity = static_cast<double>(elapsed.count()) * static_cast<double>(num_workers);
+        return capacity > 0 ? static_cast<double>(this->busy_time.count()) / capacity : 0.0;
+    }
+};
+
+/**
+* Deterministic discrete-event simulation of many MockExecutors sharing one VirtualClock, e.g. one
+* executor per simulated device.
+*
+* Actions run in the order they were posted, whichever executor they were posted to. Once nothing
+* is left to run, the clock jumps straight to the next event across all the executors: the next
+* timer expiration or the end of a handler. Timers that expire together run in deadline order, ties
+* broken by start order. Idle periods therefore cost nothing, whatever the number of executors.
+*
+* By default, handlers take no virtual time and any number of them can run at once. With a cost
+* model (set on the simulation, or per executor to override it), each handler keeps its executor
+* busy for its cost, like a strand, and with a number of workers, like the threads of a ThreadPool,
+* a handler also waits for a free worker. The handlers run at their start time, so the posts and
+* timers they make are visible to the other workers right away. SimulationStats then tell how long
+* handlers waited and how busy the workers were, e.g. to find the load that saturates a deployment.
+*
+* A run is fully determined by the handlers and the seeds of the cost models, so the same scenario
+* always produces the same interleaving. Not thread-safe: the executors must only be used by the
+* handlers and the thread driving the simulation.
+*/
+class Simulation final : private IMockScheduler
+{
+public:
+    explicit Simulation(const steady_time_t& start = steady_time_t{}) :
+        clock{VirtualClock::create(start)}
+    {}
+
+    ~Simulation()
+    {
+        while (!this->timers.empty())
+        {
+            const auto timer = this->timers.pop();
+            timer->source->release(timer);
+        }
+        for (auto& strand : this->strands)
+        {
+            strand.executor->scheduler = nullptr;
+        }
+    }
+
+    // Uncopyable
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    /// @return a new executor driven by this simulation, it must not outlive the simulation
+    std::shared_ptr<MockExecutor> create_executor()
+    {
+        const auto executor = std::make_shared<MockExecutor>(this->clock);
+        executor->scheduler = this;
+        executor->scheduler_index = this->strands.size();
+        this->strands.emplace_back(executor);
+        return executor;
+    }
+
+    /// Charge the virtual time of a model to the handlers of the executors without their own model
+    void set_cost_model(const cost_model_t& model)
+    {
+        this->cost_model = model;
+    }
+
+    /// Limit the number of handlers running at once, zero means unlimited
+    void set_num_workers(size_t num_workers)
+    {
+        this->num_workers = num_workers;
+    }
+
+    steady_time_t get_time() const
+    {
+        return this->clock->get_time();
+    }
+
+    const std::shared_ptr<VirtualClock>& get_clock() const
+    {
+        return this->clock;
+    }
+
+    /// @return true if an action was started, without moving the clock
+    bool run_one()
+    {
+        this->process_events();
+
+        if (this->runnable.empty() || (this->num_workers > 0 && this->num_busy >= this->num_workers))
+        {
+            return false;
+        }
+
+        const auto index = this->runnable.top().index;
+        this->runnable.pop();
+        this->run(index);
+        return true;
+    }
+
+    /// Start the actions that can start at the current time, @return the number of actions started
+    size_t run_many(size_t maximum = std::numeric_limits<size_t>::max())
+    {
+        size_t num = 0;
+        while (num < maximum && this->run_one()) ++num;
+        return num;
+    }
+
+    /**
+    * Run everything that happens until a time, jumping from event to event, then move the clock
+    * to that time
+    *
+    * @return the number of actions started
+    */
+    size_t run_until(const steady_time_t& time)
+    {
+        const auto count = this->run_while_before(time);
+        this->clock->advance_to(time);
+        return count;
+    }
+
+    /// Like run_until(), relative to the current time
+    size_t run_for(const duration_t& duration)
+    {
+        return this->run_until(this->get_time() + duration);
+    }
+
+    /**
+    * Run until no action is ready or running and no timer is pending. The clock is left at the
+    * last event. Never returns if timers keep being restarted, use run_until() for such scenarios.
+    *
+    * @return the number of actions started
+    */
+    size_t run_until_idle()
+    {
+        return this->run_while_before(steady_time_t::max());
+    }
+
+    /// Move the clock to the next expiration of a timer, @return false if there is none
+    bool advance_to_next_timer()
+    {
+        if (this->timers.empty())
+        {
+            return false;
+        }
+
+        this->clock->advance_to(this->timers.top()->expiration);
+        return true;
+    }
+
+    size_t num_executors() const
+    {
+        return this->strands.size();
+    }
+
+    /// @return the number of timers of all the executors that have neither expired nor been canceled
+    size_t num_pending_timers() const
+    {
+        return this->timers.size();
+    }
+
+    /// @return the number of handlers still charging their cost
+    size_t num_running() const
+    {
+        return this->completions.size();
+    }
+
+    const SimulationStats& get_stats() const
+    {
+        return this->stats;
+    }
+
+    void reset_stats()
+    {
+        this->stats = SimulationStats{};
+    }
+
+private:
+    struct Posted
+    {
+        uint64_t seq;
+        steady_time_t time;
+    };
+
+    // an executor behaves like a strand: one handler at a time
+    struct Strand
+    {
+        explicit Strand(const std::shared_ptr<MockExecutor>& executor) : executor{executor}, posted{4} {}
+
+        std::shared_ptr<MockExecutor> executor;
+        // one entry per action of the executor, in post order
+        RingQueue<Posted> posted;
+        bool is_runnable = false;
+        bool is_busy = false;
+    };
+
+    // ordered by post sequence for runnable strands, by time then sequence for completions
+    struct Entry
+    {
+        steady_time_t time;
+        uint64_t seq;
+        size_t index;
+
+        bool operator>(const Entry& other) const
+        {
+            return (this->time == other.time) ? (this->seq > other.seq) : (this->time > other.time);
+        }
+    };
+
+    using entry_queue_t = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>;
+
+    size_t run_while_before(const steady_time_t& time)
+    {
+        size_t count = 0;
+        while (true)
+        {
+            count += this->run_many();
+
+            auto next = steady_time_t::max();
+            if (!this->timers.empty())
+            {
+                next = this->timers.top()->expiration;
+            }
+            if (!this->completions.empty())
+            {
+                next = std::min(next, this->completions.top().time);
+            }
+
+            if (next == steady_time_t::max() || next > time)
+            {
+                return count;
+            }
+
+            this->clock->advance_to(next);
+        }
+    }
+
+    /// end the handlers whose cost has elapsed, then hand the expired timers over to their executors
+    void process_events()
+    {
+        const auto now = this->clock->get_time();
+
+        while (!this->completions.empty() && this->completions.top().time <= now)
+        {
+            auto& strand = this->strands[this->completions.top().index];
+            this->completions.pop();
+            --this->num_busy;
+            strand.is_busy = false;
+            this->make_runnable(strand);
+        }
+
+        while (!this->timers.empty() && this->timers.top()->expiration <= now)
+        {
+            const auto timer = this->timers.pop();
+            timer->source->expire(timer);
+        }
+    }
+
+    void make_runnable(Strand& strand)
+    {
+        if (strand.is_busy || strand.is_runnable || strand.posted.empty())
+        {
+            return;
+        }
+
+        strand.is_runnable = true;
+        // the seq of the oldest action keeps the global post order
+        this->runnable.push(Entry{steady_time_t{}, strand.posted.front().seq, strand.executor->scheduler_index});
+    }
+
+    void run(size_t index)
+    {
+        const auto now = this->clock->get_time();
+        {
+            auto& strand = this->strands[index];
+            const auto posted = strand.posted.front();
+            strand.posted.pop_front();
+            strand.is_runnable = false;
+            strand.is_busy = true;
+
+            const auto wait = now - posted.time;
+            ++this->stats.num_handlers;
+            this->stats.total_wait += wait;
+            this->stats.max_wait = std::max(this->stats.max_wait, wait);
+        }
+
+        this->strands[index].executor->run_posted();
+
+        // the handler may have created executors, which moves the strands
+        auto& strand = this->strands[index];
+        const auto& model = strand.executor->cost_model ? strand.executor->cost_model : this->cost_model;
+        const auto cost = model ? model(strand.executor->running_tag) : duration_t::zero();
+
+        if (cost > duration_t::zero())
+        {
+            ++this->num_busy;
+            this->stats.busy_time += cost;
+            this->completions.push(Entry{now + cost, this->next_seq++, index});
+            return;
+        }
+
+        strand.is_busy = false;
+        this->make_runnable(strand);
+    }
+
+    // ---- Implement IMockScheduler -----
+
+    virtual void on_post(MockExecutor& executor) override
+    {
+        auto& strand = this->strands[executor.scheduler_index];
+        strand.posted.push_back(Posted{this->next_seq++, this->clock->get_time()});
+        this->make_runnable(strand);
+    }
+
+    virtual void on_start(MockTimer& timer) override
+    {
+        this->timers.push(&timer);
+    }
+
+    virtual void on_cancel(MockTimer& timer) override
+    {
+        this->timers.remove(&timer);
+    }
+
+    const std::shared_ptr<VirtualClock> clock;
+    std::vector<Strand> strands;
+
+    cost_model_t cost_model;
+    size_t num_workers = 0;
+    size_t num_busy = 0;
+
+    uint64_t next_seq = 0;
+    entry_queue_t runnable;
+    entry_queue_t completions;
+    TimerHeap<MockTimer> timers;
+
+    SimulationStats stats;
+};
+
+}
+
+#endif
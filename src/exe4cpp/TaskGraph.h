@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_TASKGRAPH_H
+#define EXE4CPP_TASKGRAPH_H
+
+#include "exe4cpp/IExecutor.h"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace exe4cpp
+{
+
+/**
+* Directed acyclic graph of tasks executed on an executor as soon as their predecessors complete.
+*
+* Each task has an atomic counter of unfinished predecessors that is reset at the beginning of every
+* run, so the same graph can be executed many times without being rebuilt. There is no central lock:
+* the task that completes the last predecessor of a successor schedules it. When several successors
+* become ready at once, the first one runs inline on the same thread and the others are posted.
+*
+* Use an executor that runs actions concurrently (e.g. a BasicExecutor on an io_service run by a
+* ThreadPool) to execute independent tasks in parallel. The graph must not be modified while it runs.
+*
+* A task that throws aborts the run: the tasks that have not started yet are skipped, and the run
+* completes once the tasks already running return. The first exception is passed to the completion
+* handler of run(), the overload taking an action ignores it.
+*/
+class TaskGraph final : public std::enable_shared_from_this<TaskGraph>
+{
+public:
+    using task_id_t = size_t;
+    /// receives the exception of the task that aborted the run, null if all the tasks completed
+    using completion_handler_t = std::function<void(std::exception_ptr)>;
+
+    TaskGraph() = default;
+
+    // Uncopyable
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    static std::shared_ptr<TaskGraph> create()
+    {
+        return std::make_shared<TaskGraph>();
+    }
+
+    /// @return the identifier of the new task
+    task_id_t add_task(const action_t& action)
+    {
+        this->tasks.push_back(task_t{action, {}, 0});
+        this->is_validated = false;
+        return this->tasks.size() - 1;
+    }
+
+    /// Make the task 'after' wait for the completion of the task 'before'
+    void precede(task_id_t before, task_id_t after)
+    {
+        this->tasks[before].successors.push_back(after);
+        ++this->tasks[after].num_predecessors;
+        this->is_validated = false;
+    }
+
+    size_t num_tasks() const
+    {
+        return this->tasks.size();
+    }
+
+    bool is_running() const
+    {
+        return this->running.load(std::memory_order_acquire);
+    }
+
+    /// Same as the other run(), without the exception of an aborted run
+    bool run(const std::shared_ptr<IExecutor>& executor, const std::shared_ptr<IExecutor>& completion, const action_t& on_complete)
+    {
+        return this->run(executor, completion, [on_complete](std::exception_ptr)
+        {
+            on_complete();
+        });
+    }
+
+    /**
+    * Execute all the tasks on the executor and post on_complete to the completion executor once they are done
+    * or the run is aborted
+    *
+    * @return false if the graph is already running or contains a cycle
+    */
+    bool run(const std::shared_ptr<IExecutor>& executor, const std::shared_ptr<IExecutor>& completion, const completion_handler_t& on_complete)
+    {
+        if (this->running.exchange(true, std::memory_order_acq_rel))
+        {
+            return false;
+        }
+
+        if (!this->validate())
+        {
+            this->running.store(false, std::memory_order_release);
+            return false;
+        }
+
+        this->executor = executor;
+        this->completion = completion;
+        this->on_complete = on_complete;
+
+        if (this->tasks.empty())
+        {
+            this->finish();
+            return true;
+        }
+
+        for (size_t i = 0; i < this->tasks.size(); ++i)
+        {
+            this->pending[i].store(this->tasks[i].num_predecessors, std::memory_order_relaxed);
+        }
+        this->is_aborted.store(false, std::memory_order_relaxed);
+        this->remaining.store(this->tasks.size(), std::memory_order_release);
+
+        for (size_t i = 0; i < this->tasks.size(); ++i)
+        {
+            if (this->tasks[i].num_predecessors == 0)
+            {
+                this->schedule(i);
+            }
+        }
+
+        return true;
+    }
+
+private:
+    struct task_t
+    {
+        action_t action;
+        std::vector<task_id_t> successors;
+        size_t num_predecessors;
+    };
+
+    static constexpr task_id_t no_task = static_cast<task_id_t>(-1);
+
+    // checks for cycles with Kahn's algorithm and sizes the counters, only after the graph changed
+    bool validate()
+    {
+        if (this->is_validated)
+        {
+            return true;
+        }
+
+        std::vector<size_t> in_degree;
+        std::vector<task_id_t> ready;
+        in_degree.reserve(this->tasks.size());
+        for (size_t i = 0; i < this->tasks.size(); ++i)
+        {
+            in_degree.push_back(this->tasks[i].num_predecessors);
+            if (in_degree[i] == 0)
+            {
+                ready.push_back(i);
+            }
+        }
+
+        size_t num_sorted = 0;
+        while (!ready.empty())
+        {
+            const auto id = ready.back();
+            ready.pop_back();
+            ++num_sorted;
+            for (auto successor : this->tasks[id].successors)
+            {
+                if (--in_degree[successor] == 0)
+                {
+                    ready.push_back(successor);
+                }
+            }
+        }
+
+        if (num_sorted != this->tasks.size())
+        {
+            return false;
+        }
+
+        this->pending.reset(new std::atomic<size_t>[this->tasks.size()]);
+        this->is_validated = true;
+        return true;
+    }
+
+    void schedule(task_id_t id)
+    {
+        this->executor->post([self = shared_from_this(), id]()
+        {
+            self->execute(id);
+        });
+    }
+
+    void execute(task_id_t id)
+    {
+        while (id != no_task)
+        {
+            const auto& task = this->tasks[id];
+            if (!this->is_aborted.load(std::memory_order_acquire))
+            {
+                try
+                {
+                    task.action();
+                }
+                catch (...)
+                {
+                    this->abort(std::current_exception());
+                }
+            }
+
+            // continue with the first successor that becomes ready, post the others
+            task_id_t next = no_task;
+            for (auto successor : task.successors)
+            {
+                if (this->pending[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    if (next == no_task)
+                    {
+                        next = successor;
+                    }
+                    else
+                    {
+                        this->schedule(successor);
+                    }
+                }
+            }
+
+            if (this->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                this->finish();
+            }
+
+            id = next;
+        }
+    }
+
+    // skipped tasks still release their successors, so the run completes
+    void abort(std::exception_ptr error)
+    {
+        if (!this->is_aborted.exchange(true, std::memory_order_acq_rel))
+        {
+            // read by finish() after the last task
+            this->error = std::move(error);
+        }
+    }
+
+    void finish()
+    {
+        auto completion = std::move(this->completion);
+        auto on_complete = std::move(this->on_complete);
+        auto error = std::move(this->error);
+        this->error = nullptr;
+        this->executor.reset();
+
+        // the graph may be run again from on_complete
+        this->running.store(false, std::memory_order_release);
+
+        completion->post([on_complete, error]()
+        {
+            on_complete(error);
+        });
+    }
+
+    std::vector<task_t> tasks;
+    bool is_validated = false;
+
+    std::unique_ptr<std::atomic<size_t>[]> pending;
+    std::atomic<size_t> remaining{0};
+    std::atomic<bool> running{false};
+    std::atomic<bool> is_aborted{false};
+    std::exception_ptr error;
+
+    std::shared_ptr<IExecutor> executor;
+    std::shared_ptr<IExecutor> completion;
+    completion_handler_t on_complete;
+};
+
+}
+
+#endif
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_TIMERHEAP_H
+#define EXE4CPP_TIMERHEAP_H
+
+#include "exe4cpp/Typedefs.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace exe4cpp
+{
+
+/**
+* Base class of the elements of a TimerHeap, the heap stores its bookkeeping in the node itself
+*/
+struct TimerHeapNode
+{
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    steady_time_t expiration;
+
+    bool is_in_heap() const
+    {
+        return heap_index != npos;
+    }
+
+private:
+    template <typename> friend class TimerHeap;
+
+    size_t heap_index = npos;
+    uint64_t seq = 0;
+};
+
+/**
+* Intrusive binary min-heap of timers ordered by expiration, then by insertion order.
+*
+* The heap only stores pointers and never owns the nodes. Each node knows its position, so a
+* canceled timer is removed in O(log n) without searching. Not thread-safe.
+*/
+template <typename node_t>
+class TimerHeap final
+{
+public:
+    bool empty() const
+    {
+        return this->nodes.empty();
+    }
+
+    size_t size() const
+    {
+        return this->nodes.size();
+    }
+
+    /// @return the node that expires first, the heap must not be empty
+    node_t* top() const
+    {
+        return this->nodes.front();
+    }
+
+    void push(node_t* node)
+    {
+        node->seq = this->next_seq++;
+        node->heap_index = this->nodes.size();
+        this->nodes.push_back(node);
+        this->sift_up(node->heap_index);
+    }
+
+    /// @return the node that expires first, removed from the heap. The heap must not be empty.
+    node_t* pop()
+    {
+        const auto node = this->nodes.front();
+        this->remove(node);
+        return node;
+    }
+
+    /// Remove a node from anywhere in the heap, does nothing if the node is not in the heap
+    void remove(node_t* node)
+    {
+        if (!node->is_in_heap())
+        {
+            return;
+        }
+
+        const auto index = node->heap_index;
+        node->heap_index = TimerHeapNode::npos;
+
+        const auto last = this->nodes.back();
+        this->nodes.pop_back();
+        if (index == this->nodes.size())
+        {
+            return;
+        }
+
+        this->place(index, last);
+        if (index > 0 && less(last, this->nodes[(index - 1) / 2]))
+        {
+            this->sift_up(index);
+        }
+        else
+        {
+            this->sift_down(index);
+        }
+    }
+
+private:
+    static bool less(const node_t* lhs, const node_t* rhs)
+    {
+        return (lhs->expiration == rhs->expiration) ? (lhs->seq < rhs->seq) : (lhs->expiration < rhs->expiration);
+    }
+
+    void place(size_t index, node_t* node)
+    {
+        this->nodes[index] = node;
+        node->heap_index = index;
+    }
+
+    void sift_up(size_t index)
+    {
+        const auto node = this->nodes[index];
+        while (index > 0)
+        {
+            const auto parent = (index - 1) / 2;
+            if (!less(node, this->nodes[parent]))
+            {
+                break;
+            }
+            this->place(index, this->nodes[parent]);
+            index = parent;
+        }
+        this->place(index, node);
+    }
+
+    void sift_down(size_t index)
+    {
+        const auto node = this->nodes[index];
+        while (true)
+        {
+            auto child = 2 * index + 1;
+            if (child >= this->nodes.size())
+            {
+                break;
+            }
+            if (child + 1 < this->nodes.size() && less(this->nodes[child + 1], this->nodes[child]))
+            {
+                ++child;
+            }
+            if (!less(this->nodes[child], node))
+            {
+                break;
+            }
+            this->place(index, this->nodes[child]);
+            index = child;
+        }
+        this->place(index, node);
+    }
+
+    std::vector<node_t*> nodes;
+    uint64_t next_seq = 0;
+};
+
+}
+
+#endif
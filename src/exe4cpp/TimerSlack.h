@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_TIMERSLACK_H
+#define EXE4CPP_TIMERSLACK_H
+
+#include "exe4cpp/Typedefs.h"
+
+namespace exe4cpp
+{
+
+/**
+* Alignment of timer expirations for timer coalescing, similar to the timer slack of Linux.
+*
+* A timer started with a slack may fire anywhere in [expiration, expiration + slack]. Its expiration
+* is rounded up to a multiple of the largest power of two (in ticks of duration_t) not greater than
+* the slack, so timers with overlapping windows usually end up on the same instant and can share a
+* single wakeup of the executor.
+*/
+struct TimerSlack
+{
+    /// @return the alignment used for a slack, zero if the slack is zero or negative
+    static duration_t granularity(const duration_t& slack)
+    {
+        if (slack <= duration_t::zero())
+        {
+            return duration_t::zero();
+        }
+
+        auto ticks = static_cast<unsigned long long>(slack.count());
+        unsigned long long power = 1;
+        while (ticks >>= 1)
+        {
+            power <<= 1;
+        }
+        return duration_t(static_cast<duration_t::rep>(power));
+    }
+
+    /// @return the expiration rounded up to the granularity of the slack
+    static steady_time_t align(const steady_time_t& expiration, const duration_t& slack)
+    {
+        const auto step = granularity(slack).count();
+        if (step <= 1)
+        {
+            return expiration;
+        }
+
+        const auto ticks = expiration.time_since_epoch().count();
+        auto remainder = ticks % step;
+        if (remainder < 0)
+        {
+            remainder += step;
+        }
+        return remainder == 0 ? expiration : steady_time_t(duration_t(ticks - remainder + step));
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_TSCTIMESOURCE_H
+#define EXE4CPP_TSCTIMESOURCE_H
+
+#include "exe4cpp/ISteadyTimeSource.h"
+
+#include <atomic>
+#include <cstdint>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define EXE4CPP_HAS_TSC 1
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+namespace exe4cpp
+{
+
+/**
+* Time source that reads the invariant time-stamp counter of x86-64 CPUs.
+*
+* Reading the TSC avoids the vDSO call and clock source indirection of steady_clock. The counter
+* is converted to steady_clock time with a linear mapping calibrated against steady_clock at
+* construction, so the timestamps can be mixed with steady_clock ones.
+*
+* The rate is recalibrated when get_time() is called after recalibration_interval has passed
+* since the last calibration, measuring the rate over the whole lifetime of the source. The mapping
+* stays continuous across recalibrations and timestamps never go backwards. After the first
+* recalibration, the drift with steady_clock is typically a few microseconds.
+*
+* If the CPU does not advertise an invariant TSC (CPUID 0x80000007, EDX bit 8), or on other
+* architectures, steady_clock is used instead. The TSC must be synchronized across cores, which
+* is the case on the systems that advertise it as invariant.
+*/
+class TscTimeSource final : public ISteadyTimeSource
+{
+public:
+    explicit TscTimeSource(
+        duration_t recalibration_interval = std::chrono::seconds(1),
+        duration_t calibration_window = std::chrono::milliseconds(5)
+    ) : is_invariant{has_invariant_tsc()}
+    {
+        if (!this->is_invariant)
+        {
+            return;
+        }
+
+        this->anchor = sample();
+
+        // busy-wait for an initial rate, recalibration refines it over longer periods
+        const auto end = std::chrono::steady_clock::now() + calibration_window;
+        while (std::chrono::steady_clock::now() < end)
+        {
+        }
+
+        const auto now = sample();
+        this->interval_ticks = static_cast<uint64_t>(ticks_per_ns(this->anchor, now) * static_cast<double>(std::chrono::nanoseconds(recalibration_interval).count()));
+        this->publish(now.tsc, now.ns, scale_of(this->anchor, now));
+    }
+
+    // Uncopyable
+    TscTimeSource(const TscTimeSource&) = delete;
+    TscTimeSource& operator=(const TscTimeSource&) = delete;
+
+    /// @return true if the TSC is used, false if it fell back to steady_clock
+    bool is_tsc() const
+    {
+        return this->is_invariant;
+    }
+
+    /// Calibrate the rate now instead of waiting for the recalibration interval
+    void recalibrate()
+    {
+        if (!this->is_invariant || this->is_recalibrating.exchange(true, std::memory_order_acquire))
+        {
+            return;
+        }
+
+        const auto now = sample();
+
+        // continue from the current mapping so that timestamps stay monotonic, the new rate
+        // corrects the drift from then on
+        const auto mapped = this->to_ns(now.tsc);
+        this->publish(now.tsc, mapped > now.ns ? mapped : now.ns, scale_of(this->anchor, now));
+
+        this->is_recalibrating.store(false, std::memory_order_release);
+    }
+
+    virtual steady_time_t get_time() override
+    {
+#if defined(EXE4CPP_HAS_TSC)
+        if (this->is_invariant)
+        {
+            const auto tsc = __rdtsc();
+            const auto ns = this->to_ns(tsc);
+
+            const auto base = this->base_tsc.load(std::memory_order_relaxed);
+            if (tsc > base && tsc - base > this->interval_ticks)
+            {
+                this->recalibrate();
+            }
+
+            return steady_time_t(std::chrono::duration_cast<duration_t>(std::chrono::nanoseconds(ns)));
+        }
+#endif
+        return std::chrono::steady_clock::now();
+    }
+
+private:
+    // nanoseconds per tick are stored as a 32.32 fixed point number
+    static constexpr int scale_shift = 32;
+
+    struct sample_t
+    {
+        uint64_t tsc;
+        int64_t ns;
+    };
+
+    static bool has_invariant_tsc()
+    {
+#if defined(EXE4CPP_HAS_TSC)
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007)
+        {
+            return false;
+        }
+        if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0)
+        {
+            return false;
+        }
+        return (edx & (1u << 8)) != 0;
+#else
+        return false;
+#endif
+    }
+
+    /// read the TSC and steady_clock as close together as possible, keeping the tightest of a few tries
+    static sample_t sample()
+    {
+        sample_t best{0, 0};
+#if defined(EXE4CPP_HAS_TSC)
+        uint64_t best_window = UINT64_MAX;
+        for (int i = 0; i < 5; ++i)
+        {
+            const auto before = __rdtsc();
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            const auto after = __rdtsc();
+
+            if (after - before < best_window)
+            {
+                best_window = after - before;
+                best = sample_t{before + (after - before) / 2, static_cast<int64_t>(ns)};
+            }
+        }
+#endif
+        return best;
+    }
+
+    static double ticks_per_ns(const sample_t& from, const sample_t& to)
+    {
+        const auto ns = to.ns - from.ns;
+        return ns > 0 ? static_cast<double>(to.tsc - from.tsc) / static_cast<double>(ns) : 1.0;
+    }
+
+    static uint64_t scale_of(const sample_t& from, const sample_t& to)
+    {
+#if defined(EXE4CPP_HAS_TSC)
+        const auto ticks = to.tsc - from.tsc;
+        const auto ns = static_cast<unsigned __int128>(to.ns > from.ns ? to.ns - from.ns : 0);
+        if (ticks > 0)
+        {
+            return static_cast<uint64_t>((ns << scale_shift) / ticks);
+        }
+#endif
+        return uint64_t(1) << scale_shift;
+    }
+
+    /// seqlock read of the mapping, the sequence is odd while a recalibration is writing it
+    int64_t to_ns(uint64_t tsc) const
+    {
+        while (true)
+        {
+            const auto seq = this->sequence.load(std::memory_order_acquire);
+            if (seq & 1)
+            {
+                continue;
+            }
+
+            const auto tsc0 = this->base_tsc.load(std::memory_order_relaxed);
+            const auto ns0 = this->base_ns.load(std::memory_order_relaxed);
+            const auto scale = this->scale.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (this->sequence.load(std::memory_order_relaxed) != seq)
+            {
+                continue;
+            }
+
+            // a TSC read just before a recalibration may be behind the new base
+            if (tsc <= tsc0)
+            {
+                return ns0;
+            }
+
+#if defined(EXE4CPP_HAS_TSC)
+            // 128-bit product, the delta is not bounded if get_time() is not called for a long time
+            return ns0 + static_cast<int64_t>((static_cast<unsigned __int128>(tsc - tsc0) * scale) >> scale_shift);
+#else
+            return ns0 + static_cast<int64_t>(((tsc - tsc0) * scale) >> scale_shift);
+#endif
+        }
+    }
+
+    void publish(uint64_t tsc, int64_t ns, uint64_t new_scale)
+    {
+        const auto seq = this->sequence.load(std::memory_order_relaxed);
+        this->sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        this->base_tsc.store(tsc, std::memory_order_relaxed);
+        this->base_ns.store(ns, std::memory_order_relaxed);
+        this->scale.store(new_scale, std::memory_order_relaxed);
+
+        this->sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    const bool is_invariant;
+    sample_t anchor{0, 0};
+    uint64_t interval_ticks = 0;
+
+    std::atomic<bool> is_recalibrating{false};
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<uint64_t> base_tsc{0};
+    std::atomic<int64_t> base_ns{0};
+    std::atomic<uint64_t> scale{0};
+};
+
+}
+
+#endif
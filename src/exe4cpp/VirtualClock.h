@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_VIRTUALCLOCK_H
+#define EXE4CPP_VIRTUALCLOCK_H
+
+#include "exe4cpp/ISteadyTimeSource.h"
+
+#include <memory>
+
+namespace exe4cpp
+{
+
+/**
+* Manually driven clock, the time only changes when it is told to.
+*
+* A MockExecutor owns one unless it is given one to share, e.g. all the executors of a Simulation
+* read the same virtual clock. Not thread-safe, like the MockExecutor.
+*/
+class VirtualClock final : public ISteadyTimeSource
+{
+public:
+    explicit VirtualClock(const steady_time_t& start = steady_time_t{}) : now{start}
+    {}
+
+    // Uncopyable
+    VirtualClock(const VirtualClock&) = delete;
+    VirtualClock& operator=(const VirtualClock&) = delete;
+
+    static std::shared_ptr<VirtualClock> create(const steady_time_t& start = steady_time_t{})
+    {
+        return std::make_shared<VirtualClock>(start);
+    }
+
+    virtual steady_time_t get_time() override
+    {
+        return this->now;
+    }
+
+    void advance(const duration_t& duration)
+    {
+        this->now += duration;
+    }
+
+    /// Move the clock to a time, does nothing if the time is in the past
+    void advance_to(const steady_time_t& time)
+    {
+        if (time > this->now)
+        {
+            this->now = time;
+        }
+    }
+
+private:
+    steady_time_t now;
+};
+
+}
+
+#endif
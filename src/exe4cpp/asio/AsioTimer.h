@@ -22,31 +22,57 @@
  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
+#ifndef EXE4CPP_ASIO_ASIOTIMER_H
+#define EXE4CPP_ASIO_ASIOTIMER_H
+
 #include "exe4cpp/ITimer.h"
+#include "exe4cpp/asio/HandlerMemory.h"
 
 #include "asio.hpp"
 
+#include <type_traits>
+
 namespace exe4cpp
 {
 
-class AsioTimer final : public exe4cpp::ITimer
+/**
+* ITimer backed by an asio::basic_waitable_timer on any clock whose duration is duration_t.
+*
+* The time points of the clock are converted to and from steady_time_t through their time since
+* epoch, so the executors built on a clock report and accept that clock's time through IExecutor.
+* wait_traits_t tells asio how long to really wait for a duration of the clock, see ScaledClock.
+*/
+template <typename clock_t, typename wait_traits_t = asio::wait_traits<clock_t>>
+class AsioTimerT : public exe4cpp::ITimer
 {
-    friend class BasicExecutor;
-    friend class StrandExecutor;
+    static_assert(std::is_same<typename clock_t::duration, duration_t>::value, "the duration of the clock must be exe4cpp::duration_t");
+
+    friend class PriorityStrandExecutor;
 
 public:
-    AsioTimer(const std::shared_ptr<asio::io_service>& io_service) :
+    AsioTimerT(const std::shared_ptr<asio::io_service>& io_service) :
         io_service{io_service},
         impl{*io_service}
     {}
 
     // Uncopyable
-    AsioTimer(const AsioTimer&) = delete;
-    AsioTimer& operator=(const AsioTimer&) = delete;
+    AsioTimerT(const AsioTimerT&) = delete;
+    AsioTimerT& operator=(const AsioTimerT&) = delete;
 
-    static std::shared_ptr<AsioTimer> create(const std::shared_ptr<asio::io_service>& io_service)
+    static std::shared_ptr<AsioTimerT> create(const std::shared_ptr<asio::io_service>& io_service)
+    {
+        // timers are created for every start(), recycle their memory
+        return std::allocate_shared<AsioTimerT>(RecyclingAllocator<AsioTimerT>{}, io_service);
+    }
+
+    static typename clock_t::time_point to_clock(const steady_time_t& time)
+    {
+        return typename clock_t::time_point(time.time_since_epoch());
+    }
+
+    static steady_time_t from_clock(const typename clock_t::time_point& time)
     {
-        return std::make_shared<AsioTimer>(io_service);
+        return steady_time_t(time.time_since_epoch());
     }
 
     virtual void cancel() override
@@ -57,12 +83,28 @@ public:
 
     virtual steady_time_t expires_at() override
     {
-        return impl.expires_at();
+        return from_clock(impl.expires_at());
     }
 
 private:
     const std::shared_ptr<asio::io_service> io_service;
-    asio::basic_waitable_timer<std::chrono::steady_clock> impl;
+    asio::basic_waitable_timer<clock_t, wait_traits_t> impl;
+};
+
+/**
+* AsioTimerT on steady_clock
+*/
+class AsioTimer final : public AsioTimerT<std::chrono::steady_clock>
+{
+public:
+    using AsioTimerT::AsioTimerT;
+
+    static std::shared_ptr<AsioTimer> create(const std::shared_ptr<asio::io_service>& io_service)
+    {
+        return std::allocate_shared<AsioTimer>(RecyclingAllocator<AsioTimer>{}, io_service);
+    }
 };
 
 }
+
+#endif
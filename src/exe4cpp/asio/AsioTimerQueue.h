@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_ASIO_ASIOTIMERQUEUE_H
+#define EXE4CPP_ASIO_ASIOTIMERQUEUE_H
+
+#include "exe4cpp/ITimer.h"
+#include "exe4cpp/RingQueue.h"
+#include "exe4cpp/Timer.h"
+#include "exe4cpp/TimerHeap.h"
+#include "exe4cpp/asio/HandlerMemory.h"
+
+#include "asio.hpp"
+
+#include <limits>
+#include <mutex>
+
+namespace exe4cpp
+{
+
+/**
+* Timers of an asio executor, kept in a TimerHeap behind a single asio::basic_waitable_timer that
+* is armed for the earliest expiration.
+*
+* When the underlying timer fires, every timer that has expired is moved in deadline order to a
+* queue of expired actions, and on_expired is called once for the whole batch. The executor then
+* takes the actions with pop_expired() and runs them where it sees fit. Thousands of timers that
+* expire in the same tick, e.g. sessions sharing a poll period or timers aligned by a TimerSlack,
+* thus cost one completion handler instead of one each.
+*
+* Timers are recycled with HandlerMemory and the heap and queue keep their capacity, so starting,
+* canceling and firing timers does not allocate once the executor is warm.
+*/
+template <typename clock_t, typename wait_traits_t = asio::wait_traits<clock_t>>
+class AsioTimerQueue final
+{
+    struct State;
+
+    class QueuedTimer final : public exe4cpp::ITimer, public TimerHeapNode
+    {
+        friend class AsioTimerQueue;
+
+    public:
+        QueuedTimer(const std::weak_ptr<State>& state, const steady_time_t& expiration, const action_t& action) :
+            state{state},
+            action{action}
+        {
+            this->expiration = expiration;
+        }
+
+        // Uncopyable
+        QueuedTimer(const QueuedTimer&) = delete;
+        QueuedTimer& operator=(const QueuedTimer&) = delete;
+
+        virtual void cancel() override
+        {
+            const auto state = this->state.lock();
+            if (state)
+            {
+                state->cancel(this);
+            }
+        }
+
+        virtual steady_time_t expires_at() override
+        {
+            return this->expiration;
+        }
+
+    private:
+        const std::weak_ptr<State> state;
+        action_t action;
+        // set while the timer is in the heap
+        std::shared_ptr<QueuedTimer> self;
+    };
+
+    struct State
+    {
+        State(asio::io_service& io_service) : impl{io_service} {}
+
+        ~State()
+        {
+            // break the self references of the timers that never expired
+            while (!this->heap.empty())
+            {
+                this->heap.pop()->self.reset();
+            }
+        }
+
+        void cancel(QueuedTimer* timer)
+        {
+            std::shared_ptr<QueuedTimer> self;
+            {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                if (!timer->is_in_heap())
+                {
+                    return;
+                }
+                this->heap.remove(timer);
+                self = std::move(timer->self);
+
+                if (this->heap.empty())
+                {
+                    this->disarm();
+                }
+            }
+            // the action is destroyed outside of the lock
+        }
+
+        void disarm()
+        {
+            ++this->generation;
+            this->armed_at = steady_time_t::max();
+            std::error_code ec;
+            this->impl.cancel(ec);
+        }
+
+        std::mutex mutex;
+        asio::basic_waitable_timer<clock_t, wait_traits_t> impl;
+        TimerHeap<QueuedTimer> heap;
+        RingQueue<action_t> expired;
+        // only the wait of the current generation acts on completion
+        uint64_t generation = 0;
+        steady_time_t armed_at = steady_time_t::max();
+    };
+
+public:
+    AsioTimerQueue(const std::shared_ptr<asio::io_service>& io_service) :
+        io_service{io_service},
+        state{std::make_shared<State>(*io_service)}
+    {}
+
+    // Uncopyable
+    AsioTimerQueue(const AsioTimerQueue&) = delete;
+    AsioTimerQueue& operator=(const AsioTimerQueue&) = delete;
+
+    /**
+    * Add a timer to the heap, re-arming the underlying timer if it expires first
+    *
+    * @param on_expired callable without arguments, called on the io_service after a batch of
+    * expired actions was queued. It is responsible for keeping the executor alive.
+    */
+    template <typename on_expired_t>
+    Timer start(const steady_time_t& expiration, const action_t& action, const on_expired_t& on_expired)
+    {
+        // timers are created for every start(), recycle their memory
+        const auto timer = std::allocate_shared<QueuedTimer>(RecyclingAllocator<QueuedTimer>{}, this->state, expiration, action);
+
+        std::lock_guard<std::mutex> lock{this->state->mutex};
+        timer->self = timer;
+        this->state->heap.push(timer.get());
+        if (expiration < this->state->armed_at)
+        {
+            arm(this->state, expiration, on_expired);
+        }
+
+        return Timer(timer);
+    }
+
+    /// Take the next expired action in deadline order, @return false if there is none
+    bool pop_expired(action_t& action)
+    {
+        std::lock_guard<std::mutex> lock{this->state->mutex};
+        if (this->state->expired.empty())
+        {
+            return false;
+        }
+        action = std::move(this->state->expired.front());
+        this->state->expired.pop_front();
+        return true;
+    }
+
+    /// @return the number of timers that have not expired nor been canceled
+    size_t num_pending() const
+    {
+        std::lock_guard<std::mutex> lock{this->state->mutex};
+        return this->state->heap.size();
+    }
+
+private:
+    // must be called with the lock held
+    template <typename on_expired_t>
+    static void arm(const std::shared_ptr<State>& state, const steady_time_t& expiration, const on_expired_t& on_expired)
+    {
+        const auto generation = ++state->generation;
+        state->armed_at = expiration;
+        state->impl.expires_at(typename clock_t::time_point(expiration.time_since_epoch()));
+
+        auto callback = [state, generation, on_expired](const std::error_code & ec)
+        {
+            if (ec)   // re-armed or disarmed
+            {
+                return;
+            }
+
+            if (expire(state, generation, on_expired))
+            {
+                on_expired();
+            }
+        };
+
+        state->impl.async_wait(make_recycling_handler(std::move(callback)));
+    }
+
+    /// @return true if expired actions were queued
+    template <typename on_expired_t>
+    static bool expire(const std::shared_ptr<State>& state, uint64_t generation, const on_expired_t& on_expired)
+    {
+        std::lock_guard<std::mutex> lock{state->mutex};
+
+        // the wait completed just before being re-armed, the current wait covers its timers
+        if (generation != state->generation)
+        {
+            return false;
+        }
+
+        state->armed_at = steady_time_t::max();
+
+        const steady_time_t now{clock_t::now().time_since_epoch()};
+        bool is_expired = false;
+        while (!state->heap.empty() && state->heap.top()->expiration <= now)
+        {
+            const auto timer = state->heap.pop();
+            state->expired.push_back(std::move(timer->action));
+            timer->self.reset();
+            is_expired = true;
+        }
+
+        if (!state->heap.empty())
+        {
+            arm(state, state->heap.top()->expiration, on_expired);
+        }
+
+        return is_expired;
+    }
+
+    const std::shared_ptr<asio::io_service> io_service;
+    const std::shared_ptr<State> state;
+};
+
+}
+
+#endif
@@ -25,8 +25,10 @@
 #ifndef EXE4CPP_ASIO_BASICEXECUTOR_H
 #define EXE4CPP_ASIO_BASICEXECUTOR_H
 
+#include "exe4cpp/CachedTimeSource.h"
 #include "exe4cpp/IExecutor.h"
 #include "exe4cpp/asio/AsioTimer.h"
+#include "exe4cpp/asio/AsioTimerQueue.h"
 
 #include "asio.hpp"
 
@@ -39,26 +41,45 @@ namespace exe4cpp
 *
 * Should only be used when asio::io_context::run() is called from a single thread
 *
+* get_time() reads steady_clock unless another time source is configured, e.g. a CoarseTimeSource.
+* A CachedTimeSource is invalidated before each handler runs.
+*
+* The clock of the timers and of get_time() is a template parameter, see AsioTimerT. BasicExecutor
+* is the usual steady_clock executor.
+*
+* Timers share a single underlying asio timer and those that expire together are run from one
+* completion handler, in deadline order, see AsioTimerQueue. Timers started with a slack are
+* aligned so that they expire together.
+*
 */
-class BasicExecutor final :
+template <typename clock_t, typename wait_traits_t = asio::wait_traits<clock_t>>
+class BasicExecutorT :
     public exe4cpp::IExecutor,
-    public std::enable_shared_from_this<BasicExecutor>
+    public std::enable_shared_from_this<BasicExecutorT<clock_t, wait_traits_t>>
 {
+    using timer_t = AsioTimerT<clock_t, wait_traits_t>;
+
 public:
-    BasicExecutor(const std::shared_ptr<asio::io_service>& io_service) : io_service{io_service}
+    BasicExecutorT(const std::shared_ptr<asio::io_service>& io_service, const std::shared_ptr<ISteadyTimeSource>& time_source = nullptr) :
+        io_service{io_service},
+        time_source{time_source},
+        cache{std::dynamic_pointer_cast<CachedTimeSource>(time_source)},
+        timers{io_service}
     {}
 
     // Uncopyable
-    BasicExecutor(const BasicExecutor&) = delete;
-    BasicExecutor& operator=(const BasicExecutor&) = delete;
+    BasicExecutorT(const BasicExecutorT&) = delete;
+    BasicExecutorT& operator=(const BasicExecutorT&) = delete;
 
-    static std::shared_ptr<BasicExecutor> create(const std::shared_ptr<asio::io_service>& io_service)
+    static std::shared_ptr<BasicExecutorT> create(const std::shared_ptr<asio::io_service>& io_service, const std::shared_ptr<ISteadyTimeSource>& time_source = nullptr)
     {
-        return std::make_shared<BasicExecutor>(io_service);
+        return std::make_shared<BasicExecutorT>(io_service, time_source);
     }
 
     // ---- Implement IExecutor -----
 
+    using IExecutor::start;
+
     virtual Timer start(const duration_t& duration, const action_t& action) override
     {
         return this->start(this->get_time() + duration, action);
@@ -66,32 +87,35 @@ public:
 
     virtual Timer start(const steady_time_t& expiration, const action_t& action) override
     {
-        const auto timer = AsioTimer::create(this->io_service);
-
-        timer->impl.expires_at(expiration);
-
-        // neither the executor nor the timer can be deleted while the timer is still active
-        auto callback = [timer, action, self = shared_from_this()](const std::error_code & ec)
+        // the executor cannot be deleted while a batch of expired timers is pending
+        auto on_expired = [self = this->shared_from_this()]()
         {
-            if (!ec)   // an error indicate timer was canceled
-            {
-                action();
-            }
+            self->run_expired();
         };
 
-        timer->impl.async_wait(callback);
-
-        return Timer(timer);
+        return this->timers.start(expiration, action, on_expired);
     }
 
     virtual void post(const action_t& action) override
     {
-        this->io_service->post(action);
+        if (this->cache)
+        {
+            auto callback = [action = action, self = this->shared_from_this()]()
+            {
+                self->cache->invalidate();
+                action();
+            };
+
+            this->io_service->post(make_recycling_handler(std::move(callback)));
+            return;
+        }
+
+        this->io_service->post(make_recycling_handler(action));
     }
 
     virtual steady_time_t get_time() override
     {
-        return std::chrono::steady_clock::now();
+        return this->time_source ? this->time_source->get_time() : timer_t::from_clock(clock_t::now());
     }
 
     // lots of ASIO components must be initialized with a reference to the io_service
@@ -100,9 +124,47 @@ public:
         return io_service;
     }
 
+    /// @return the number of timers that have neither expired nor been canceled
+    size_t num_pending_timers() const
+    {
+        return this->timers.num_pending();
+    }
+
 private:
+    void run_expired()
+    {
+        action_t action;
+        while (this->timers.pop_expired(action))
+        {
+            if (this->cache)
+            {
+                this->cache->invalidate();
+            }
+            action();
+        }
+    }
+
     // we hold a shared_ptr to the io_service so that it cannot dissapear while the executor is still around
     const std::shared_ptr<asio::io_service> io_service;
+
+    const std::shared_ptr<ISteadyTimeSource> time_source;
+    const std::shared_ptr<CachedTimeSource> cache;
+
+    AsioTimerQueue<clock_t, wait_traits_t> timers;
+};
+
+/**
+* BasicExecutorT on steady_clock
+*/
+class BasicExecutor final : public BasicExecutorT<std::chrono::steady_clock>
+{
+public:
+    using BasicExecutorT::BasicExecutorT;
+
+    static std::shared_ptr<BasicExecutor> create(const std::shared_ptr<asio::io_service>& io_service, const std::shared_ptr<ISteadyTimeSource>& time_source = nullptr)
+    {
+        return std::make_shared<BasicExecutor>(io_service, time_source);
+    }
 };
 
 }
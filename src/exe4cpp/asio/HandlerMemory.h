@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_ASIO_HANDLERMEMORY_H
+#define EXE4CPP_ASIO_HANDLERMEMORY_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace exe4cpp
+{
+
+/**
+* Per-thread cache of the memory blocks used by asio operations and timers.
+*
+* Blocks are grouped in a few size classes that fit exe4cpp's own handler wrappers and timers, and
+* each block remembers the cache of the thread that allocated it. A block freed by that thread goes
+* straight back to its cache, up to a fixed number per class. A block freed by another thread, e.g.
+* a worker of a ThreadPool running a handler posted by a producer, is pushed onto a lock-free return
+* list of the owning cache, which the owner takes back in one go once its own list is empty. A steady
+* stream of posts and timers is therefore served without calling the global allocator, whichever
+* thread runs the handlers.
+*
+* The cache of an exiting thread is handed over to the next thread that needs one, so blocks still
+* in flight are never orphaned. Larger requests use the global allocator directly, as do the
+* requests made while the thread is exiting.
+*/
+class HandlerMemory final
+{
+public:
+    HandlerMemory() = delete;
+
+    static void* allocate(std::size_t size)
+    {
+        const auto index = size_class(size);
+        if (index >= num_classes)
+        {
+            return ::operator new(size);
+        }
+
+        depot_t* owner = nullptr;
+        if (!is_exiting())
+        {
+            owner = cache().get();
+            auto& list = owner->lists[index];
+            if (!list.head)
+            {
+                list.reclaim(owner->returned[index]);
+            }
+            if (list.head)
+            {
+                return payload(list.pop());
+            }
+        }
+
+        // always the full size of the class, the block may be recycled by a live thread
+        auto block = static_cast<header_t*>(::operator new(sizeof(header_t) + block_size(index)));
+        block->owner = owner;
+        return payload(block);
+    }
+
+    static void deallocate(void* pointer, std::size_t size)
+    {
+        const auto index = size_class(size);
+        if (index >= num_classes)
+        {
+            ::operator delete(pointer);
+            return;
+        }
+
+        auto block = header(pointer);
+        const auto owner = block->owner;
+        if (owner && !is_exiting())
+        {
+            if (owner != cache().get())
+            {
+                owner->give_back(index, block);
+                return;
+            }
+
+            auto& list = owner->lists[index];
+            if (list.count < max_blocks_per_class)
+            {
+                list.push(block);
+                return;
+            }
+        }
+        ::operator delete(block);
+    }
+
+private:
+    // classes of 64, 128, 256 and 512 bytes
+    static constexpr std::size_t num_classes = 4;
+    static constexpr std::size_t min_block_size = 64;
+    static constexpr std::size_t max_blocks_per_class = 256;
+
+    struct depot_t;
+
+    // precedes each block of a size class, keeps the payload aligned for any type
+    struct alignas(std::max_align_t) header_t
+    {
+        // null if the block is not recycled
+        depot_t* owner;
+        // next free block in a list
+        header_t* next;
+    };
+
+    struct list_t
+    {
+        header_t* head = nullptr;
+        std::size_t count = 0;
+
+        void push(header_t* block)
+        {
+            block->next = this->head;
+            this->head = block;
+            ++this->count;
+        }
+
+        header_t* pop()
+        {
+            const auto block = this->head;
+            this->head = block->next;
+            --this->count;
+            return block;
+        }
+
+        void reclaim(std::atomic<header_t*>& returned)
+        {
+            // only the owner takes from the return list, and it takes it whole, so there is no ABA
+            this->head = returned.exchange(nullptr, std::memory_order_acquire);
+            for (auto block = this->head; block; block = block->next)
+            {
+                ++this->count;
+            }
+        }
+    };
+
+    // the blocks of a thread, owned by one thread at a time and never freed
+    struct depot_t
+    {
+        depot_t()
+        {
+            for (auto& list : returned)
+            {
+                list.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        void give_back(std::size_t index, header_t* block)
+        {
+            auto& list = this->returned[index];
+            block->next = list.load(std::memory_order_relaxed);
+            while (!list.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed))
+            {}
+        }
+
+        list_t lists[num_classes];
+        // blocks freed by other threads
+        std::atomic<header_t*> returned[num_classes];
+        // next depot waiting for a thread
+        depot_t* next_free = nullptr;
+    };
+
+    class cache_t
+    {
+    public:
+        ~cache_t()
+        {
+            is_exiting() = true;
+            if (this->depot)
+            {
+                std::lock_guard<std::mutex> lock{free_depots_mutex()};
+                this->depot->next_free = free_depots();
+                free_depots() = this->depot;
+            }
+        }
+
+        depot_t* get()
+        {
+            if (!this->depot)
+            {
+                {
+                    std::lock_guard<std::mutex> lock{free_depots_mutex()};
+                    this->depot = free_depots();
+                    if (this->depot)
+                    {
+                        free_depots() = this->depot->next_free;
+                    }
+                }
+                if (!this->depot)
+                {
+                    this->depot = new depot_t();
+                }
+            }
+            return this->depot;
+        }
+
+    private:
+        depot_t* depot = nullptr;
+    };
+
+    static std::size_t size_class(std::size_t size)
+    {
+        std::size_t index = 0;
+        auto limit = min_block_size;
+        while (index < num_classes && size > limit)
+        {
+            ++index;
+            limit <<= 1;
+        }
+        return index;
+    }
+
+    static std::size_t block_size(std::size_t index)
+    {
+        return min_block_size << index;
+    }
+
+    static void* payload(header_t* block)
+    {
+        return block + 1;
+    }
+
+    static header_t* header(void* pointer)
+    {
+        return static_cast<header_t*>(pointer) - 1;
+    }
+
+    static cache_t& cache()
+    {
+        static thread_local cache_t instance;
+        return instance;
+    }
+
+    // trivially destructible, so it remains usable after the cache of the thread is destroyed
+    static bool& is_exiting()
+    {
+        static thread_local bool exiting = false;
+        return exiting;
+    }
+
+    // never destroyed, threads may exit after the static destructors have run
+    static std::mutex& free_depots_mutex()
+    {
+        static auto mutex = new std::mutex();
+        return *mutex;
+    }
+
+    static depot_t*& free_depots()
+    {
+        static depot_t* head = nullptr;
+        return head;
+    }
+};
+
+/**
+* Standard allocator backed by HandlerMemory, e.g. for std::allocate_shared
+*/
+template <typename T>
+class RecyclingAllocator
+{
+public:
+    using value_type = T;
+
+    RecyclingAllocator() noexcept = default;
+
+    template <typename U>
+    RecyclingAllocator(const RecyclingAllocator<U>&) noexcept
+    {}
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(HandlerMemory::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t n)
+    {
+        HandlerMemory::deallocate(pointer, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const RecyclingAllocator<U>&) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const RecyclingAllocator<U>&) const noexcept
+    {
+        return false;
+    }
+};
+
+/**
+* Wraps an asio completion handler so that asio allocates its operation from HandlerMemory
+*
+* Both the associated allocator (asio >= 1.11) and the legacy allocation hooks are provided, and
+* the hooks are forwarded by asio::strand::wrap().
+*/
+template <typename handler_t>
+class RecyclingHandler
+{
+public:
+    using allocator_type = RecyclingAllocator<void>;
+
+    explicit RecyclingHandler(handler_t&& handler) : handler{std::move(handler)}
+    {}
+
+    explicit RecyclingHandler(const handler_t& handler) : handler{handler}
+    {}
+
+    allocator_type get_allocator() const noexcept
+    {
+        return allocator_type{};
+    }
+
+    template <typename... args_t>
+    void operator()(args_t&&... args)
+    {
+        handler(std::forward<args_t>(args)...);
+    }
+
+    template <typename... args_t>
+    void operator()(args_t&&... args) const
+    {
+        handler(std::forward<args_t>(args)...);
+    }
+
+    friend void* asio_handler_allocate(std::size_t size, RecyclingHandler*)
+    {
+        return HandlerMemory::allocate(size);
+    }
+
+    friend void asio_handler_deallocate(void* pointer, std::size_t size, RecyclingHandler*)
+    {
+        HandlerMemory::deallocate(pointer, size);
+    }
+
+private:
+    handler_t handler;
+};
+
+template <typename handler_t>
+RecyclingHandler<typename std::decay<handler_t>::type> make_recycling_handler(handler_t&& handler)
+{
+    return RecyclingHandler<typename std::decay<handler_t>::type>{std::forward<handler_t>(handler)};
+}
+
+}
+
+#endif
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_ASIO_KEYEDEXECUTOR_H
+#define EXE4CPP_ASIO_KEYEDEXECUTOR_H
+
+#include "exe4cpp/asio/StrandExecutor.h"
+
+#include "asio.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace exe4cpp
+{
+
+/**
+*
+* Serializes work per key by hashing keys onto a fixed set of StrandExecutor instances.
+*
+* All the work posted for a given key is executed in post order and never concurrently. Keys that
+* hash onto the same strand are also serialized with each other, so the number of strands bounds
+* both the memory used and the available parallelism, independently of the number of keys.
+*
+*/
+template <typename key_t, typename hash_t = std::hash<key_t>>
+class KeyedExecutor final
+{
+public:
+    KeyedExecutor(const std::shared_ptr<asio::io_service>& io_service, size_t num_strands, const hash_t& hash = hash_t()) :
+        io_service{io_service},
+        hash{hash}
+    {
+        if (num_strands == 0)
+        {
+            num_strands = 1;
+        }
+
+        strands.reserve(num_strands);
+        for (size_t i = 0; i < num_strands; ++i)
+        {
+            strands.push_back(StrandExecutor::create(io_service));
+        }
+    }
+
+    // Uncopyable
+    KeyedExecutor(const KeyedExecutor&) = delete;
+    KeyedExecutor& operator=(const KeyedExecutor&) = delete;
+
+    static std::shared_ptr<KeyedExecutor> create(const std::shared_ptr<asio::io_service>& io_service, size_t num_strands, const hash_t& hash = hash_t())
+    {
+        return std::make_shared<KeyedExecutor>(io_service, num_strands, hash);
+    }
+
+    /// Post an event that is serialized with every other event of the same key
+    void post(const key_t& key, const action_t& action)
+    {
+        this->get_executor(key)->post(action);
+    }
+
+    /// @return start a new timer based on a relative time duration, serialized with the events of the key
+    Timer start(const key_t& key, const duration_t& duration, const action_t& action)
+    {
+        return this->get_executor(key)->start(duration, action);
+    }
+
+    /// @return start a new timer based on an absolute timestamp, serialized with the events of the key
+    Timer start(const key_t& key, const steady_time_t& expiration, const action_t& action)
+    {
+        return this->get_executor(key)->start(expiration, action);
+    }
+
+    /// @return the strand that serializes the events of the key, can be handed out as an IExecutor
+    const std::shared_ptr<StrandExecutor>& get_executor(const key_t& key) const
+    {
+        return this->strands[this->index_of(key)];
+    }
+
+    /// @return the index of the strand that serializes the events of the key
+    size_t index_of(const key_t& key) const
+    {
+        return static_cast<size_t>(mix(static_cast<uint64_t>(this->hash(key))) % this->strands.size());
+    }
+
+    size_t num_strands() const
+    {
+        return this->strands.size();
+    }
+
+    inline std::shared_ptr<asio::io_service> get_service()
+    {
+        return io_service;
+    }
+
+private:
+    // std::hash is the identity for integers on common implementations, so spread the bits before
+    // the modulo to keep regular key patterns (e.g. device IDs that are multiples of N) balanced
+    static uint64_t mix(uint64_t value)
+    {
+        value ^= value >> 30;
+        value *= 0xbf58476d1ce4e5b9ULL;
+        value ^= value >> 27;
+        value *= 0x94d049bb133111ebULL;
+        value ^= value >> 31;
+        return value;
+    }
+
+    const std::shared_ptr<asio::io_service> io_service;
+    const hash_t hash;
+    std::vector<std::shared_ptr<StrandExecutor>> strands;
+};
+
+}
+
+#endif
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_ASIO_PRIORITYSTRANDEXECUTOR_H
+#define EXE4CPP_ASIO_PRIORITYSTRANDEXECUTOR_H
+
+#include "exe4cpp/IExecutor.h"
+#include "exe4cpp/RingQueue.h"
+#include "exe4cpp/asio/AsioTimer.h"
+#include "exe4cpp/asio/HandlerMemory.h"
+
+#include "asio.hpp"
+
+#include <mutex>
+#include <vector>
+
+namespace exe4cpp
+{
+
+/**
+*
+* Serialized executor, like StrandExecutor, with a fixed number of priority lanes
+*
+* Lane 0 has the highest priority. Events of a lane are executed in post order, and events of
+* all the lanes are never executed concurrently. Lanes are served by weighted round-robin: in every
+* round a lane may execute up to its weight in events before lower priority lanes get their share,
+* so a burst on a high priority lane cannot starve the others.
+*
+* A single drain handler is queued on the io_service at a time. It executes at most one round of
+* events and then re-posts itself so that other work sharing the io_service is not delayed.
+*
+*/
+class PriorityStrandExecutor final :
+    public exe4cpp::IExecutor,
+    public std::enable_shared_from_this<PriorityStrandExecutor>
+{
+public:
+    /// @param weights the number of events each lane may execute per round, index 0 is the highest priority
+    PriorityStrandExecutor(const std::shared_ptr<asio::io_service>& io_service, const std::vector<size_t>& weights) :
+        io_service{io_service},
+        lanes(weights.empty() ? 1 : weights.size())
+    {
+        size_t i = 0;
+        for (auto& lane : lanes)
+        {
+            lane.weight = (i < weights.size() && weights[i] > 0) ? weights[i] : 1;
+            lane.credits = lane.weight;
+            this->round_size += lane.weight;
+            ++i;
+        }
+    }
+
+    // Uncopyable
+    PriorityStrandExecutor(const PriorityStrandExecutor&) = delete;
+    PriorityStrandExecutor& operator=(const PriorityStrandExecutor&) = delete;
+
+    static std::shared_ptr<PriorityStrandExecutor> create(const std::shared_ptr<asio::io_service>& io_service, const std::vector<size_t>& weights)
+    {
+        return std::make_shared<PriorityStrandExecutor>(io_service, weights);
+    }
+
+    size_t num_lanes() const
+    {
+        return this->lanes.size();
+    }
+
+    /// Post an event on a lane, events posted without a lane go to the lowest priority lane
+    void post(size_t lane, const action_t& action)
+    {
+        action_t copy{action};
+        this->enqueue(lane, std::move(copy));
+    }
+
+    /// @return start a new timer whose action is posted on a lane when it expires
+    Timer start(size_t lane, const steady_time_t& expiration, const action_t& action)
+    {
+        const auto timer = AsioTimer::create(this->io_service);
+
+        timer->impl.expires_at(expiration);
+
+        // neither this executor nor the timer can be deleted while the timer is still active
+        auto callback = [timer, lane, action = action, self = shared_from_this()](const std::error_code & ec) mutable
+        {
+            if (!ec)   // an error indicate timer was canceled
+            {
+                self->enqueue(lane, std::move(action));
+            }
+        };
+
+        timer->impl.async_wait(make_recycling_handler(std::move(callback)));
+
+        return Timer(timer);
+    }
+
+    // ---- Implement IExecutor -----
+
+    using IExecutor::start;
+
+    virtual Timer start(const duration_t& duration, const action_t& action) override
+    {
+        return this->start(get_time() + duration, action);
+    }
+
+    virtual Timer start(const steady_time_t& expiration, const action_t& action) override
+    {
+        return this->start(this->lanes.size() - 1, expiration, action);
+    }
+
+    virtual void post(const action_t& action) override
+    {
+        this->post(this->lanes.size() - 1, action);
+    }
+
+    virtual steady_time_t get_time() override
+    {
+        return std::chrono::steady_clock::now();
+    }
+
+    inline std::shared_ptr<asio::io_service> get_service()
+    {
+        return io_service;
+    }
+
+private:
+    struct lane_t
+    {
+        RingQueue<action_t> actions;
+        size_t weight = 1;
+        size_t credits = 1;
+    };
+
+    void enqueue(size_t lane, action_t&& action)
+    {
+        {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            this->lanes[std::min(lane, this->lanes.size() - 1)].actions.push_back(std::move(action));
+            if (this->is_scheduled)
+            {
+                return;
+            }
+            this->is_scheduled = true;
+        }
+
+        this->schedule();
+    }
+
+    void schedule()
+    {
+        auto callback = [self = shared_from_this()]()
+        {
+            self->drain();
+        };
+
+        this->io_service->post(make_recycling_handler(std::move(callback)));
+    }
+
+    void drain()
+    {
+        action_t action;
+        for (size_t i = 0; i < this->round_size; ++i)
+        {
+            {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                if (!this->pop_next(action))
+                {
+                    this->is_scheduled = false;
+                    return;
+                }
+            }
+
+            try
+            {
+                action();
+            }
+            catch (...)
+            {
+                // the drain is still marked as scheduled, the next one serves the remaining events
+                this->schedule();
+                throw;
+            }
+        }
+
+        // yield to the other handlers of the io_service, the next round starts at the tail of the queue
+        this->schedule();
+    }
+
+    // must be called with the mutex held
+    bool pop_next(action_t& action)
+    {
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            bool has_work = false;
+            for (auto& lane : this->lanes)
+            {
+                if (lane.actions.empty())
+                {
+                    continue;
+                }
+
+                has_work = true;
+                if (lane.credits > 0)
+                {
+                    --lane.credits;
+                    action = std::move(lane.actions.front());
+                    lane.actions.pop_front();
+                    return true;
+                }
+            }
+
+            if (!has_work)
+            {
+                return false;
+            }
+
+            // every lane with pending work has used its share, start a new round
+            for (auto& lane : this->lanes)
+            {
+                lane.credits = lane.weight;
+            }
+        }
+
+        return false;
+    }
+
+    // we hold a shared_ptr to the io_service so that it cannot dissapear while the executor is still executing
+    const std::shared_ptr<asio::io_service> io_service;
+
+    std::mutex mutex;
+    bool is_scheduled = false;
+    std::vector<lane_t> lanes;
+    size_t round_size = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_ASIO_SCALEDCLOCK_H
+#define EXE4CPP_ASIO_SCALEDCLOCK_H
+
+#include "exe4cpp/asio/BasicExecutor.h"
+#include "exe4cpp/asio/StrandExecutor.h"
+
+#include <chrono>
+#include <mutex>
+
+namespace exe4cpp
+{
+
+/**
+* Steady clock that runs faster (or slower) than real time by a process-wide scale factor.
+*
+* Used with the asio executors, a scale of 100 makes a 24 hour soak test of the real asio stack
+* run in about 15 minutes: timers expire, and get_time() advances, 100 times faster, while
+* sockets and handlers keep running in real time.
+*
+* The clock starts at the steady_clock time of its first use. Changing the scale keeps the clock
+* continuous, but timers already waiting keep the real wait computed with the previous scale.
+*/
+class ScaledClock
+{
+public:
+    using duration = std::chrono::steady_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<ScaledClock>;
+    static constexpr bool is_steady = true;
+
+    static time_point now()
+    {
+        auto& state = get_state();
+        std::lock_guard<std::mutex> lock{state.mutex};
+        return state.now(std::chrono::steady_clock::now());
+    }
+
+    static void set_scale(double scale)
+    {
+        auto& state = get_state();
+        std::lock_guard<std::mutex> lock{state.mutex};
+        const auto real = std::chrono::steady_clock::now();
+        state.origin = state.now(real);
+        state.real_origin = real;
+        state.scale = scale > 0 ? scale : 1.0;
+    }
+
+    static double get_scale()
+    {
+        auto& state = get_state();
+        std::lock_guard<std::mutex> lock{state.mutex};
+        return state.scale;
+    }
+
+    /// Tells asio how long to really wait for a duration of the scaled clock
+    struct WaitTraits
+    {
+        static duration to_wait_duration(const duration& d)
+        {
+            return std::chrono::duration_cast<duration>(std::chrono::duration<double, period>(d) / get_scale());
+        }
+
+        static duration to_wait_duration(const time_point& t)
+        {
+            const auto current = now();
+            return (t > current) ? to_wait_duration(t - current) : duration::zero();
+        }
+    };
+
+private:
+    struct state_t
+    {
+        time_point now(const std::chrono::steady_clock::time_point& real) const
+        {
+            return this->origin + std::chrono::duration_cast<duration>(std::chrono::duration<double, period>(real - this->real_origin) * this->scale);
+        }
+
+        std::mutex mutex;
+        std::chrono::steady_clock::time_point real_origin = std::chrono::steady_clock::now();
+        time_point origin = time_point(real_origin.time_since_epoch());
+        double scale = 1.0;
+    };
+
+    static state_t& get_state()
+    {
+        static state_t state;
+        return state;
+    }
+};
+
+using ScaledBasicExecutor = BasicExecutorT<ScaledClock, ScaledClock::WaitTraits>;
+using ScaledStrandExecutor = StrandExecutorT<ScaledClock, ScaledClock::WaitTraits>;
+
+}
+
+#endif
@@ -25,45 +25,98 @@
 #ifndef EXE4CPP_ASIO_STRANDEXECUTOR_H
 #define EXE4CPP_ASIO_STRANDEXECUTOR_H
 
+#include "exe4cpp/CachedTimeSource.h"
 #include "exe4cpp/IExecutor.h"
+#include "exe4cpp/RingQueue.h"
 #include "exe4cpp/asio/AsioTimer.h"
+#include "exe4cpp/asio/AsioTimerQueue.h"
 
 #include "asio.hpp"
 
+#include <mutex>
+
 namespace exe4cpp
 {
 
+/**
+* Limits how long a StrandExecutor may keep a thread busy before yielding to other strands
+*
+* A value of zero means no limit for that criterion. The default budget is unlimited.
+*/
+struct StrandBudget
+{
+    /// maximum number of events executed per turn
+    size_t max_handlers = 0;
+    /// maximum time spent executing events per turn, checked after each event
+    std::chrono::microseconds max_time = std::chrono::microseconds::zero();
+
+    bool is_limited() const
+    {
+        return max_handlers > 0 || max_time > std::chrono::microseconds::zero();
+    }
+};
+
 /**
 *
 * Implementation of openpal::IExecutor backed by asio::strand
 *
 * Shutdown life-cycle guarantees are provided by using std::shared_ptr
 *
+* With a limited StrandBudget, events are queued by the executor and executed in turns: once a turn
+* has used its budget, the strand re-enqueues itself at the tail of the io_service queue so that
+* many strands sharing a ThreadPool get a fair share of the threads.
+*
+* get_time() reads steady_clock unless another time source is configured, e.g. a CoarseTimeSource.
+* A CachedTimeSource is invalidated before each handler runs.
+*
+* The clock of the timers and of get_time() is a template parameter, see AsioTimerT. StrandExecutor
+* is the usual steady_clock executor.
+*
+* Timers share a single underlying asio timer, see AsioTimerQueue. The timers that expire together
+* run as one event of the strand, in deadline order, or are queued together with a limited budget.
+* Timers started with a slack are aligned so that they expire together.
+*
 */
-class StrandExecutor final :
+template <typename clock_t, typename wait_traits_t = asio::wait_traits<clock_t>>
+class StrandExecutorT :
     public exe4cpp::IExecutor,
-    public std::enable_shared_from_this<StrandExecutor>
+    public std::enable_shared_from_this<StrandExecutorT<clock_t, wait_traits_t>>
 {
+    using timer_t = AsioTimerT<clock_t, wait_traits_t>;
 
 public:
 
-    StrandExecutor(const std::shared_ptr<asio::io_service>& io_service) :
-        io_service{io_service},
-        strand{*io_service}
+    StrandExecutorT(
+        const std::shared_ptr<asio::io_service>& io_service,
+        const StrandBudget& budget = StrandBudget{},
+        const std::shared_ptr<ISteadyTimeSource>& time_source = nullptr
+    ) : io_service{io_service},
+        strand{*io_service},
+        time_source{time_source},
+        cache{std::dynamic_pointer_cast<CachedTimeSource>(time_source)},
+        budget{budget},
+        timers{io_service}
     {}
 
-    static std::shared_ptr<StrandExecutor> create(const std::shared_ptr<asio::io_service>& io_service)
+    static std::shared_ptr<StrandExecutorT> create(
+        const std::shared_ptr<asio::io_service>& io_service,
+        const StrandBudget& budget = StrandBudget{},
+        const std::shared_ptr<ISteadyTimeSource>& time_source = nullptr
+    )
     {
-        return std::make_shared<StrandExecutor>(io_service);
+        return std::make_shared<StrandExecutorT>(io_service, budget, time_source);
     }
 
-    std::shared_ptr<StrandExecutor> fork()
+    /// @return a new strand on the same io_service with the same budget and time source
+    std::shared_ptr<StrandExecutorT> fork()
     {
-        return create(this->io_service);
+        return create(this->io_service, this->budget, this->time_source);
     }
 
     // ---- Implement IExecutor -----
 
+    using IExecutor::start;
+
     virtual Timer start(const duration_t& duration, const action_t& action) override
     {
         return this->start(get_time() + duration, action);
@@ -71,37 +124,48 @@ public:
 
     virtual Timer start(const steady_time_t& expiration, const action_t& action) override
     {
-        const auto timer = AsioTimer::create(this->io_service);
-
-        timer->impl.expires_at(expiration);
-
-        // neither this executor nor the timer can be deleted while the timer is still active
-        auto callback = [timer, action, self = shared_from_this()](const std::error_code & ec)
+        // this executor cannot be deleted while a batch of expired timers is pending
+        auto on_expired = [self = this->shared_from_this()]()
         {
-            if (!ec)   // an error indicate timer was canceled
+            if (self->budget.is_limited())
             {
-                action();
+                // expired timers wait for their turn like any other event
+                self->enqueue_expired();
+                return;
             }
-        };
 
-        timer->impl.async_wait(strand.wrap(callback));
+            // dispatch by hand rather than with strand.wrap, which copies the handler twice per completion
+            auto run = [self]()
+            {
+                self->run_expired();
+            };
+            self->strand.dispatch(make_recycling_handler(std::move(run)));
+        };
 
-        return Timer(timer);
+        return this->timers.start(expiration, action, on_expired);
     }
 
     virtual void post(const action_t& action) override
     {
-        auto callback = [action, self = shared_from_this()]()
+        if (this->budget.is_limited())
         {
+            action_t copy{action};
+            this->enqueue(std::move(copy));
+            return;
+        }
+
+        auto callback = [action = action, self = this->shared_from_this()]()
+        {
+            self->invalidate_cache();
             action();
         };
 
-        strand.post(callback);
+        strand.post(make_recycling_handler(std::move(callback)));
     }
 
     virtual steady_time_t get_time() override
     {
-        return std::chrono::steady_clock::now();
+        return this->time_source ? this->time_source->get_time() : timer_t::from_clock(clock_t::now());
     }
 
     inline std::shared_ptr<asio::io_service> get_service()
@@ -115,10 +179,168 @@ public:
         return strand.wrap(handler);
     }
 
+    const StrandBudget& get_budget() const
+    {
+        return budget;
+    }
+
+    const std::shared_ptr<ISteadyTimeSource>& get_time_source() const
+    {
+        return time_source;
+    }
+
+    /// @return the number of timers that have neither expired nor been canceled
+    size_t num_pending_timers() const
+    {
+        return this->timers.num_pending();
+    }
+
 private:
+    void invalidate_cache()
+    {
+        if (this->cache)
+        {
+            this->cache->invalidate();
+        }
+    }
+
+    void run_expired()
+    {
+        action_t action;
+        while (this->timers.pop_expired(action))
+        {
+            this->invalidate_cache();
+            action();
+        }
+    }
+
+    void enqueue_expired()
+    {
+        {
+            // move the whole batch under the lock so that concurrent batches do not interleave
+            std::lock_guard<std::mutex> lock{this->mutex};
+            action_t action;
+            while (this->timers.pop_expired(action))
+            {
+                this->queue.push_back(std::move(action));
+            }
+            if (this->is_scheduled || this->queue.empty())
+            {
+                return;
+            }
+            this->is_scheduled = true;
+        }
+
+        this->schedule_turn();
+    }
+
+    void enqueue(action_t&& action)
+    {
+        {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            this->queue.push_back(std::move(action));
+            if (this->is_scheduled)
+            {
+                return;
+            }
+            this->is_scheduled = true;
+        }
+
+        this->schedule_turn();
+    }
+
+    void schedule_turn()
+    {
+        auto callback = [self = this->shared_from_this()]()
+        {
+            self->run_turn();
+        };
+
+        strand.post(make_recycling_handler(std::move(callback)));
+    }
+
+    void run_turn()
+    {
+        const bool is_timed = this->budget.max_time > std::chrono::microseconds::zero();
+        const auto start = is_timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+
+        size_t count = 0;
+        while (true)
+        {
+            action_t action;
+            {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                if (this->queue.empty())
+                {
+                    this->is_scheduled = false;
+                    return;
+                }
+                action = std::move(this->queue.front());
+                this->queue.pop_front();
+            }
+
+            this->invalidate_cache();
+            try
+            {
+                action();
+            }
+            catch (...)
+            {
+                // the turn is still marked as scheduled, the next one runs the rest of the queue
+                this->schedule_turn();
+                throw;
+            }
+            ++count;
+
+            if ((this->budget.max_handlers > 0 && count >= this->budget.max_handlers) ||
+                (is_timed && std::chrono::steady_clock::now() - start >= this->budget.max_time))
+            {
+                break;
+            }
+        }
+
+        // budget is exhausted, go back to the tail of the io_service queue
+        this->schedule_turn();
+    }
+
     // we hold a shared_ptr to the io_service so that it cannot dissapear while the strand is still executing
     const std::shared_ptr<asio::io_service> io_service;
     asio::strand strand;
+
+    const std::shared_ptr<ISteadyTimeSource> time_source;
+    const std::shared_ptr<CachedTimeSource> cache;
+
+    // only used with a limited budget
+    const StrandBudget budget;
+    std::mutex mutex;
+    bool is_scheduled = false;
+    RingQueue<action_t> queue;
+
+    AsioTimerQueue<clock_t, wait_traits_t> timers;
+};
+
+/**
+* StrandExecutorT on steady_clock
+*/
+class StrandExecutor final : public StrandExecutorT<std::chrono::steady_clock>
+{
+public:
+    using StrandExecutorT::StrandExecutorT;
+
+    static std::shared_ptr<StrandExecutor> create(
+        const std::shared_ptr<asio::io_service>& io_service,
+        const StrandBudget& budget = StrandBudget{},
+        const std::shared_ptr<ISteadyTimeSource>& time_source = nullptr
+    )
+    {
+        return std::make_shared<StrandExecutor>(io_service, budget, time_source);
+    }
+
+    /// @return a new strand on the same io_service with the same budget and time source
+    std::shared_ptr<StrandExecutor> fork()
+    {
+        return create(this->get_service(), this->get_budget(), this->get_time_source());
+    }
 };
 
 }
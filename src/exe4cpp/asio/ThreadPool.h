@@ -36,6 +36,9 @@ namespace exe4cpp
 
 /**
 *	A thread pool that calls asio::io_service::run
+*
+*	Executors post straight to the io_service, whose scheduler only signals a thread that is idle.
+*	The wakeup coalescing of the Linux EventLoop is not applied to the pool.
 */
 class ThreadPool
 {
@@ -100,6 +103,12 @@ public:
         }
     }
 
+    /// @return the number of threads running the io_service
+    size_t num_threads() const
+    {
+        return threads.size();
+    }
+
 private:
     void run(uint32_t threadnum)
     {
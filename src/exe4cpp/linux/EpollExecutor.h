@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_LINUX_EPOLLEXECUTOR_H
+#define EXE4CPP_LINUX_EPOLLEXECUTOR_H
+
+#include "exe4cpp/linux/EventLoop.h"
+
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+#include <functional>
+#include <unordered_map>
+
+namespace exe4cpp
+{
+
+/**
+* Linux-native event loop implementing IExecutor without asio.
+*
+* The loop waits in epoll_wait on:
+* - the eventfd of the EventLoop, written by post() and stop() to wake it from other threads,
+* - a timerfd armed at the earliest expiration of the timer heap,
+* - the file descriptors registered with watch().
+*
+* watch() and unwatch() may be called from any thread, the I/O callbacks run on the loop.
+*/
+class EpollExecutor final : public EventLoop
+{
+public:
+    /// receives the epoll events (EPOLLIN, EPOLLOUT, ...) of a watched file descriptor
+    using io_callback_t = std::function<void(uint32_t events)>;
+
+    EpollExecutor() :
+        epoll_fd{check(::epoll_create1(EPOLL_CLOEXEC), "epoll_create1")},
+        timer_fd{check(::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC), "timerfd_create")}
+    {
+        this->add_internal(this->event_fd);
+        this->add_internal(this->timer_fd);
+    }
+
+    ~EpollExecutor()
+    {
+        ::close(this->timer_fd);
+        ::close(this->epoll_fd);
+    }
+
+    static std::shared_ptr<EpollExecutor> create()
+    {
+        return std::make_shared<EpollExecutor>();
+    }
+
+    /**
+    * Register a file descriptor, the callback is executed on the loop when one of the events is ready.
+    * Watching a descriptor again replaces its events and callback.
+    *
+    * @throw std::system_error if epoll rejects the descriptor, the previous watch is then left as it was
+    */
+    void watch(int fd, uint32_t events, const io_callback_t& callback)
+    {
+        std::shared_ptr<io_callback_t> previous;
+        {
+            std::lock_guard<std::mutex> lock{this->watch_mutex};
+            auto& watch = this->watches[fd];
+            previous = std::move(watch);
+            watch = std::make_shared<io_callback_t>(callback);
+        }
+
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = fd;
+        auto result = ::epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, fd, &event);
+        if (result < 0 && errno == EEXIST)
+        {
+            result = ::epoll_ctl(this->epoll_fd, EPOLL_CTL_MOD, fd, &event);
+        }
+
+        if (result < 0)
+        {
+            const auto error = errno;
+            {
+                std::lock_guard<std::mutex> lock{this->watch_mutex};
+                if (previous)
+                {
+                    this->watches[fd] = std::move(previous);
+                }
+                else
+                {
+                    this->watches.erase(fd);
+                }
+            }
+            throw std::system_error(error, std::system_category(), "epoll_ctl");
+        }
+    }
+
+    /// Stop watching a file descriptor, must be called before the descriptor is closed
+    void unwatch(int fd)
+    {
+        ::epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+
+        std::lock_guard<std::mutex> lock{this->watch_mutex};
+        this->watches.erase(fd);
+    }
+
+protected:
+    virtual size_t wait(bool block, const steady_time_t& next_expiration) override
+    {
+        this->arm_timer_fd(next_expiration);
+
+        epoll_event events[max_events];
+        const auto num_events = ::epoll_wait(this->epoll_fd, events, max_events, block ? -1 : 0);
+        if (num_events < 0 && errno != EINTR)
+        {
+            check(num_events, "epoll_wait");
+        }
+
+        size_t count = 0;
+        for (int i = 0; i < num_events; ++i)
+        {
+            const auto fd = events[i].data.fd;
+            if (fd == this->event_fd)
+            {
+                this->consume_wakeup();
+                continue;
+            }
+            if (fd == this->timer_fd)
+            {
+                uint64_t value;
+                (void)::read(fd, &value, sizeof(value));
+                this->armed_expiration = steady_time_t::max();
+                continue;
+            }
+
+            std::shared_ptr<io_callback_t> callback;
+            {
+                std::lock_guard<std::mutex> lock{this->watch_mutex};
+                const auto iter = this->watches.find(fd);
+                if (iter == this->watches.end())
+                {
+                    continue;   // unwatched by an earlier callback of this iteration
+                }
+                callback = iter->second;
+            }
+
+            (*callback)(events[i].events);
+            ++count;
+        }
+
+        return count;
+    }
+
+private:
+    static constexpr int max_events = 64;
+
+    void add_internal(int fd)
+    {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        check(::epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, fd, &event), "epoll_ctl");
+    }
+
+    void arm_timer_fd(const steady_time_t& next)
+    {
+        if (next == this->armed_expiration)
+        {
+            return;
+        }
+        this->armed_expiration = next;
+
+        itimerspec spec{};
+        if (next != steady_time_t::max())
+        {
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(next.time_since_epoch()).count();
+            // a zero value would disarm the timerfd, expirations in the past fire immediately
+            spec.it_value.tv_sec = (ns > 0) ? ns / 1000000000 : 0;
+            spec.it_value.tv_nsec = (ns > 0) ? ns % 1000000000 : 1;
+        }
+        ::timerfd_settime(this->timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr);
+    }
+
+    const int epoll_fd;
+    const int timer_fd;
+
+    std::mutex watch_mutex;
+    std::unordered_map<int, std::shared_ptr<io_callback_t>> watches;
+
+    // only accessed by the loop thread
+    steady_time_t armed_expiration = steady_time_t::max();
+};
+
+}
+
+#endif
@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_LINUX_EVENTLOOP_H
+#define EXE4CPP_LINUX_EVENTLOOP_H
+
+#include "exe4cpp/ILoopExecutor.h"
+#include "exe4cpp/RingQueue.h"
+#include "exe4cpp/TimerHeap.h"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <system_error>
+
+namespace exe4cpp
+{
+
+class EventLoop;
+
+/**
+* Timer of an EventLoop, kept alive by the loop until it expires or is canceled
+*/
+class LoopTimer final : public ITimer, public TimerHeapNode
+{
+    friend class EventLoop;
+
+public:
+    LoopTimer(const std::weak_ptr<EventLoop>& loop, const steady_time_t& expiration, const action_t& action) :
+        loop{loop},
+        action{action}
+    {
+        this->expiration = expiration;
+    }
+
+    // Uncopyable
+    LoopTimer(const LoopTimer&) = delete;
+    LoopTimer& operator=(const LoopTimer&) = delete;
+
+    virtual void cancel() override;
+
+    virtual steady_time_t expires_at() override
+    {
+        return this->expiration;
+    }
+
+private:
+    const std::weak_ptr<EventLoop> loop;
+    action_t action;
+    // set while the timer is in the heap of the loop
+    std::shared_ptr<LoopTimer> self;
+};
+
+/**
+* Counters of an EventLoop, see EventLoop::get_stats()
+*/
+struct LoopStats
+{
+    /// number of post() calls
+    uint64_t num_posts = 0;
+    /// number of times the eventfd was written to wake the loop up
+    uint64_t num_wakeups = 0;
+    /// posts made while the loop was running handlers, which need no wakeup
+    uint64_t num_posted_while_awake = 0;
+    /// posts made while the loop was sleeping but a wakeup was already pending
+    uint64_t num_coalesced = 0;
+};
+
+/**
+* Backend-independent part of the Linux event loops: the posted actions, the timer heap and the
+* eventfd used to wake the loop from other threads.
+*
+* Wakeups are coalesced: the eventfd is only written when the loop is blocked in the backend and
+* no wakeup is pending yet. Posts made while the loop is running handlers are picked up by the next
+* iteration without any system call, and a burst of posts to a sleeping loop costs a single write.
+*
+* post(), start() and cancel() may be called from any thread. The loop is run by a single thread
+* calling run() or poll(). Each iteration waits in the backend, which dispatches the I/O
+* completions, then runs the expired timers in deadline order, then the actions that were posted
+* before the timers ran.
+*
+* Errors from the system calls throw std::system_error.
+*/
+class EventLoop :
+    public ILoopExecutor,
+    public std::enable_shared_from_this<EventLoop>
+{
+    friend class LoopTimer;
+
+public:
+    EventLoop() : event_fd{check(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC), "eventfd")}
+    {}
+
+    virtual ~EventLoop()
+    {
+        // break the self references of the timers that never fired
+        while (!this->timers.empty())
+        {
+            this->timers.pop()->self.reset();
+        }
+
+        ::close(this->event_fd);
+    }
+
+    // Uncopyable
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // ---- Implement ILoopExecutor -----
+
+    virtual void run() override
+    {
+        while (!this->is_stopped.load(std::memory_order_acquire))
+        {
+            this->run_iteration(true);
+        }
+    }
+
+    virtual size_t poll() override
+    {
+        return this->run_iteration(false);
+    }
+
+    virtual void stop() override
+    {
+        this->is_stopped.store(true, std::memory_order_release);
+        this->write_wakeup();
+    }
+
+    virtual void restart() override
+    {
+        this->is_stopped.store(false, std::memory_order_release);
+    }
+
+    // ---- Implement IExecutor -----
+
+    using IExecutor::start;
+
+    virtual Timer start(const duration_t& duration, const action_t& action) override
+    {
+        return this->start(this->get_time() + duration, action);
+    }
+
+    virtual Timer start(const steady_time_t& expiration, const action_t& action) override
+    {
+        const auto timer = std::make_shared<LoopTimer>(shared_from_this(), expiration, action);
+
+        bool needs_wakeup = false;
+        {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            timer->self = timer;
+            this->timers.push(timer.get());
+            // the backend re-arms its timer when the loop wakes up
+            needs_wakeup = (this->timers.top() == timer.get()) && this->request_wakeup();
+        }
+
+        if (needs_wakeup)
+        {
+            this->write_wakeup();
+        }
+
+        return Timer(timer);
+    }
+
+    virtual void post(const action_t& action) override
+    {
+        bool needs_wakeup = false;
+        {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            this->posted.push_back(action);
+            ++this->stats.num_posts;
+            if (!this->is_sleeping)
+            {
+                ++this->stats.num_posted_while_awake;
+            }
+            else if (this->is_wakeup_pending)
+            {
+                ++this->stats.num_coalesced;
+            }
+            needs_wakeup = this->request_wakeup();
+        }
+
+        if (needs_wakeup)
+        {
+            this->write_wakeup();
+        }
+    }
+
+    virtual steady_time_t get_time() override
+    {
+        return std::chrono::steady_clock::now();
+    }
+
+    LoopStats get_stats()
+    {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        return this->stats;
+    }
+
+protected:
+    static int check(int result, const char* what)
+    {
+        if (result < 0)
+        {
+            throw std::system_error(errno, std::system_category(), what);
+        }
+        return result;
+    }
+
+    /**
+    * Wait for I/O, a wakeup or the expiration, and execute the I/O callbacks that are ready
+    *
+    * @param block false to only collect what is already ready
+    * @param next_expiration earliest timer expiration, steady_time_t::max() if there is none
+    * @return the number of I/O callbacks that were executed
+    */
+    virtual size_t wait(bool block, const steady_time_t& next_expiration) = 0;
+
+    /// reset the eventfd after the backend saw it readable
+    void consume_wakeup()
+    {
+        // read before clearing the flag: a write made in between would otherwise be consumed while
+        // the flag stays set, and later posts would wait for a wakeup that never comes
+        uint64_t value;
+        (void)::read(this->event_fd, &value, sizeof(value));
+
+        std::lock_guard<std::mutex> lock{this->mutex};
+        this->is_wakeup_pending = false;
+    }
+
+    const int event_fd;
+
+private:
+    /// @return true if the caller must write the eventfd, must be called with the mutex held
+    bool request_wakeup()
+    {
+        if (!this->is_sleeping || this->is_wakeup_pending)
+        {
+            return false;
+        }
+
+        this->is_wakeup_pending = true;
+        ++this->stats.num_wakeups;
+        return true;
+    }
+
+    void write_wakeup()
+    {
+        const uint64_t one = 1;
+        // EAGAIN means the counter is saturated, the loop is woken up anyway
+        (void)::write(this->event_fd, &one, sizeof(one));
+    }
+
+    void cancel(LoopTimer& timer)
+    {
+        std::shared_ptr<LoopTimer> self;
+        {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            if (!timer.is_in_heap())
+            {
+                return;
+            }
+            this->timers.remove(&timer);
+            self = std::move(timer.self);
+        }
+        // the action is released outside of the lock
+    }
+
+    size_t run_iteration(bool block)
+    {
+        steady_time_t next_expiration;
+        {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            block = block && this->posted.empty();
+            next_expiration = this->timers.empty() ? steady_time_t::max() : this->timers.top()->expiration;
+            // from now on, posts and earlier timers must wake the loop up
+            this->is_sleeping = block;
+        }
+
+        size_t count = this->wait(block, next_expiration);
+
+        {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            this->is_sleeping = false;
+        }
+
+        count += this->run_expired_timers();
+        count += this->run_posted();
+        return count;
+    }
+
+    size_t run_expired_timers()
+    {
+        const auto now = this->get_time();
+
+        size_t count = 0;
+        while (true)
+        {
+            std::shared_ptr<LoopTimer> timer;
+            {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                if (this->timers.empty() || this->timers.top()->expiration > now)
+                {
+                    return count;
+                }
+                timer = std::move(this->timers.pop()->self);
+            }
+
+            timer->action();
+            ++count;
+        }
+    }
+
+    size_t run_posted()
+    {
+        {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            if (this->posted.empty())
+            {
+                return 0;
+            }
+            this->running.swap(this->posted);
+        }
+
+        // actions posted by these handlers run on the next iteration
+        size_t count = 0;
+        while (!this->running.empty())
+        {
+            const auto action = std::move(this->running.front());
+            this->running.pop_front();
+            action();
+            ++count;
+        }
+        return count;
+    }
+
+    std::atomic<bool> is_stopped{false};
+
+    std::mutex mutex;
+    RingQueue<action_t> posted;
+    TimerHeap<LoopTimer> timers;
+    bool is_sleeping = false;
+    bool is_wakeup_pending = false;
+    LoopStats stats;
+
+    // only accessed by the loop thread
+    RingQueue<action_t> running;
+};
+
+inline void LoopTimer::cancel()
+{
+    if (const auto exe = this->loop.lock())
+    {
+        exe->cancel(*this);
+    }
+}
+
+}
+
+#endif
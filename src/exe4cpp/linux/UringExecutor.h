@@ -0,0 +1,421 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_LINUX_URINGEXECUTOR_H
+#define EXE4CPP_LINUX_URINGEXECUTOR_H
+
+#include "exe4cpp/linux/EpollExecutor.h"
+#include "exe4cpp/linux/EventLoop.h"
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define EXE4CPP_HAS_IO_URING 1
+#endif
+#endif
+
+#if defined(EXE4CPP_HAS_IO_URING)
+
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace exe4cpp
+{
+
+/**
+* Linux event loop driven by io_uring, implementing IExecutor without asio or liburing.
+*
+* - post() and stop() wake the loop through the eventfd of the EventLoop, watched with a one-shot
+*   IORING_OP_POLL_ADD. IORING_OP_MSG_RING needs a ring on the sending side, which the threads
+*   posting to the executor do not have.
+* - the earliest timer of the heap is an absolute IORING_OP_TIMEOUT, replaced with
+*   IORING_OP_TIMEOUT_REMOVE when an earlier timer is started.
+* - the application can submit its own operations on the same ring with submit(), so that the
+*   I/O, the wakeup and the timer of an iteration share a single io_uring_enter() call.
+*
+* io_uring needs Linux 5.5 or later and may be disabled by the kernel or a seccomp policy, use
+* is_supported() or create_loop_executor() to fall back to the EpollExecutor.
+*/
+class UringExecutor final : public EventLoop
+{
+public:
+    /// receives the result of an operation, i.e. the res field of its completion queue entry
+    using completion_t = std::function<void(int32_t result)>;
+
+    explicit UringExecutor(unsigned entries = 256)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        this->ring_fd = check(static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params)), "io_uring_setup");
+
+        try
+        {
+            this->map_rings(params);
+        }
+        catch (...)
+        {
+            this->unmap_rings();
+            ::close(this->ring_fd);
+            throw;
+        }
+
+        this->arm_wakeup();
+    }
+
+    ~UringExecutor()
+    {
+        this->unmap_rings();
+        ::close(this->ring_fd);
+    }
+
+    static std::shared_ptr<UringExecutor> create(unsigned entries = 256)
+    {
+        return std::make_shared<UringExecutor>(entries);
+    }
+
+    /// @return true if io_uring can be used by this process, the result is probed once
+    static bool is_supported()
+    {
+        static const bool is_supported = probe();
+        return is_supported;
+    }
+
+    /**
+    * Submit an application operation on the ring of the loop, must be called on the loop thread
+    *
+    * @param prepare fills the submission queue entry (opcode, fd, addr, len, ...), user_data is reserved
+    * @param on_complete executed on the loop with the result of the operation
+    */
+    void submit(const std::function<void(io_uring_sqe&)>& prepare, const completion_t& on_complete)
+    {
+        const auto id = (this->next_io_id++ << tag_bits) | tag_io;
+        auto& sqe = this->get_sqe();
+        prepare(sqe);
+        sqe.user_data = id;
+        this->pending_io[id] = on_complete;
+    }
+
+protected:
+    virtual size_t wait(bool block, const steady_time_t& next_expiration) override
+    {
+        this->arm_timeout(next_expiration);
+
+        const auto num_submitted = this->enter(block ? 1 : 0);
+        (void)num_submitted;
+
+        return this->reap();
+    }
+
+private:
+    // the two low bits of user_data tell the kind of operation
+    static constexpr uint64_t tag_bits = 2;
+    static constexpr uint64_t tag_io = 0;
+    static constexpr uint64_t tag_wakeup = 1;
+    static constexpr uint64_t tag_timeout = 2;
+    static constexpr uint64_t tag_timeout_remove = 3;
+
+    struct cqe_t
+    {
+        uint64_t user_data;
+        int32_t result;
+    };
+
+    static bool probe()
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        const auto fd = static_cast<int>(::syscall(__NR_io_uring_setup, 2, &params));
+        if (fd < 0)
+        {
+            return false;
+        }
+        ::close(fd);
+
+        // first reported by Linux 5.5, which also has IORING_OP_TIMEOUT_REMOVE
+        return (params.features & IORING_FEAT_SUBMIT_STABLE) != 0;
+    }
+
+    void* map(size_t size, uint64_t offset)
+    {
+        const auto ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->ring_fd, static_cast<off_t>(offset));
+        if (ptr == MAP_FAILED)
+        {
+            throw std::system_error(errno, std::system_category(), "mmap");
+        }
+        return ptr;
+    }
+
+    void map_rings(const io_uring_params& params)
+    {
+        this->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        this->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        const bool is_single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (is_single)
+        {
+            this->sq_size = this->cq_size = std::max(this->sq_size, this->cq_size);
+        }
+
+        this->sq_ptr = static_cast<uint8_t*>(this->map(this->sq_size, IORING_OFF_SQ_RING));
+        this->cq_ptr = is_single ? this->sq_ptr : static_cast<uint8_t*>(this->map(this->cq_size, IORING_OFF_CQ_RING));
+        this->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        this->sqes = static_cast<io_uring_sqe*>(this->map(this->sqes_size, IORING_OFF_SQES));
+
+        this->sq_head = reinterpret_cast<unsigned*>(this->sq_ptr + params.sq_off.head);
+        this->sq_tail = reinterpret_cast<unsigned*>(this->sq_ptr + params.sq_off.tail);
+        this->sq_mask = *reinterpret_cast<unsigned*>(this->sq_ptr + params.sq_off.ring_mask);
+        this->sq_array = reinterpret_cast<unsigned*>(this->sq_ptr + params.sq_off.array);
+        this->sq_entries = params.sq_entries;
+
+        this->cq_head = reinterpret_cast<unsigned*>(this->cq_ptr + params.cq_off.head);
+        this->cq_tail = reinterpret_cast<unsigned*>(this->cq_ptr + params.cq_off.tail);
+        this->cq_mask = *reinterpret_cast<unsigned*>(this->cq_ptr + params.cq_off.ring_mask);
+        this->cqes = reinterpret_cast<io_uring_cqe*>(this->cq_ptr + params.cq_off.cqes);
+
+        this->local_tail = *this->sq_tail;
+    }
+
+    void unmap_rings()
+    {
+        if (this->sqes)
+        {
+            ::munmap(this->sqes, this->sqes_size);
+        }
+        if (this->cq_ptr && this->cq_ptr != this->sq_ptr)
+        {
+            ::munmap(this->cq_ptr, this->cq_size);
+        }
+        if (this->sq_ptr)
+        {
+            ::munmap(this->sq_ptr, this->sq_size);
+        }
+    }
+
+    /// @return a zeroed submission queue entry, submitting the queued ones if the queue is full
+    io_uring_sqe& get_sqe()
+    {
+        while (this->local_tail - __atomic_load_n(this->sq_head, __ATOMIC_ACQUIRE) >= this->sq_entries)
+        {
+            this->enter(0);
+        }
+
+        const auto index = this->local_tail & this->sq_mask;
+        auto& sqe = this->sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        this->sq_array[index] = index;
+        ++this->local_tail;
+        ++this->num_queued;
+        return sqe;
+    }
+
+    /// submit the queued entries and optionally wait for completions
+    int enter(unsigned min_complete)
+    {
+        __atomic_store_n(this->sq_tail, this->local_tail, __ATOMIC_RELEASE);
+
+        const auto result = static_cast<int>(::syscall(__NR_io_uring_enter, this->ring_fd, this->num_queued, min_complete, IORING_ENTER_GETEVENTS, nullptr, 0));
+        if (result < 0)
+        {
+            if (errno == EBUSY || errno == EAGAIN)
+            {
+                // the completion queue is full, make room for the kernel before the caller retries
+                this->collect();
+            }
+            else if (errno != EINTR)
+            {
+                check(result, "io_uring_enter");
+            }
+            return 0;
+        }
+
+        this->num_queued -= std::min(this->num_queued, static_cast<unsigned>(result));
+        return result;
+    }
+
+    void arm_wakeup()
+    {
+        auto& sqe = this->get_sqe();
+        sqe.opcode = IORING_OP_POLL_ADD;
+        sqe.fd = this->event_fd;
+        sqe.poll_events = POLLIN;
+        sqe.user_data = tag_wakeup;
+    }
+
+    void arm_timeout(const steady_time_t& next)
+    {
+        if (next == this->armed_expiration)
+        {
+            return;
+        }
+
+        if (this->armed_expiration != steady_time_t::max())
+        {
+            auto& sqe = this->get_sqe();
+            sqe.opcode = IORING_OP_TIMEOUT_REMOVE;
+            sqe.addr = (this->timeout_generation << tag_bits) | tag_timeout;
+            sqe.user_data = tag_timeout_remove;
+        }
+
+        this->armed_expiration = next;
+        if (next == steady_time_t::max())
+        {
+            return;
+        }
+
+        // the kernel copies the timespec when the entry is submitted, during this iteration
+        const auto ns = std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(next.time_since_epoch()).count());
+        this->timeout_spec.tv_sec = ns / 1000000000;
+        this->timeout_spec.tv_nsec = ns % 1000000000;
+
+        auto& sqe = this->get_sqe();
+        sqe.opcode = IORING_OP_TIMEOUT;
+        sqe.addr = reinterpret_cast<uint64_t>(&this->timeout_spec);
+        sqe.len = 1;
+        sqe.timeout_flags = IORING_TIMEOUT_ABS;
+        sqe.user_data = (++this->timeout_generation << tag_bits) | tag_timeout;
+    }
+
+    /// move the completion queue entries to the completions to dispatch
+    void collect()
+    {
+        auto head = *this->cq_head;
+        const auto tail = __atomic_load_n(this->cq_tail, __ATOMIC_ACQUIRE);
+        while (head != tail)
+        {
+            const auto& cqe = this->cqes[head & this->cq_mask];
+            this->completions.push_back(cqe_t{cqe.user_data, cqe.res});
+            ++head;
+        }
+        __atomic_store_n(this->cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    /// consume the completion queue, then dispatch the completions
+    size_t reap()
+    {
+        this->collect();
+
+        // dispatching may submit, and a full completion queue then collects more completions
+        size_t count = 0;
+        for (size_t i = 0; i < this->completions.size(); ++i)
+        {
+            const auto cqe = this->completions[i];
+            switch (cqe.user_data & ((1 << tag_bits) - 1))
+            {
+            case tag_wakeup:
+                this->consume_wakeup();
+                this->arm_wakeup();
+                break;
+            case tag_timeout:
+                // a replaced timeout completes with -ECANCELED, only the current one disarms
+                if ((cqe.user_data >> tag_bits) == this->timeout_generation)
+                {
+                    this->armed_expiration = steady_time_t::max();
+                }
+                break;
+            case tag_io:
+            {
+                const auto iter = this->pending_io.find(cqe.user_data);
+                if (iter != this->pending_io.end())
+                {
+                    const auto callback = std::move(iter->second);
+                    this->pending_io.erase(iter);
+                    callback(cqe.result);
+                    ++count;
+                }
+                break;
+            }
+            default:
+                break;
+            }
+        }
+        this->completions.clear();
+
+        return count;
+    }
+
+    int ring_fd = -1;
+
+    uint8_t* sq_ptr = nullptr;
+    uint8_t* cq_ptr = nullptr;
+    io_uring_sqe* sqes = nullptr;
+    size_t sq_size = 0;
+    size_t cq_size = 0;
+    size_t sqes_size = 0;
+
+    unsigned* sq_head = nullptr;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned sq_mask = 0;
+    unsigned sq_entries = 0;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned cq_mask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    // only accessed by the loop thread
+    unsigned local_tail = 0;
+    unsigned num_queued = 0;
+    steady_time_t armed_expiration = steady_time_t::max();
+    uint64_t timeout_generation = 0;
+    __kernel_timespec timeout_spec{};
+    uint64_t next_io_id = 0;
+    std::unordered_map<uint64_t, completion_t> pending_io;
+    std::vector<cqe_t> completions;
+};
+
+/// @return an io_uring loop if the kernel supports it, an epoll loop otherwise
+inline std::shared_ptr<ILoopExecutor> create_loop_executor()
+{
+    if (UringExecutor::is_supported())
+    {
+        return UringExecutor::create();
+    }
+    return EpollExecutor::create();
+}
+
+}
+
+#else
+
+namespace exe4cpp
+{
+
+/// @return an epoll loop, io_uring headers are not available
+inline std::shared_ptr<ILoopExecutor> create_loop_executor()
+{
+    return EpollExecutor::create();
+}
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_TEST_ALLOCATIONAUDIT_H
+#define EXE4CPP_TEST_ALLOCATIONAUDIT_H
+
+#include "AllocationCounter.h"
+
+#include "asio.hpp"
+
+#include <cstddef>
+
+/**
+* Runs an operation num_ops times per round on a manually polled io_service, and returns the number
+* of allocations made by the calling thread during the last round, once the handler and timer caches
+* are warm
+*/
+template <typename operation_t>
+std::size_t count_steady_state_allocations(asio::io_service& io_service, std::size_t num_ops, const operation_t& operation)
+{
+    const int num_warmup_rounds = 3;
+
+    std::size_t count = 0;
+    for (int round = 0; round <= num_warmup_rounds; ++round)
+    {
+        AllocationCounter counter;
+        for (std::size_t i = 0; i < num_ops; ++i)
+        {
+            operation();
+        }
+        io_service.poll();
+        io_service.restart();
+        count = counter.count();
+    }
+
+    return count;
+}
+
+#endif
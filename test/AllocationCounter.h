@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EXE4CPP_TEST_ALLOCATIONCOUNTER_H
+#define EXE4CPP_TEST_ALLOCATIONCOUNTER_H
+
+#include <cstddef>
+
+/**
+* Counts the calls to the global operator new made by the current thread while it is in scope.
+*
+* The counting replacement of the global allocation functions is in AllocationCounter.cpp.
+*/
+class AllocationCounter
+{
+public:
+    AllocationCounter();
+
+    /// @return the number of allocations made by this thread since construction
+    std::size_t count() const;
+
+    /// @return the number of allocations made by this thread since the program started
+    static std::size_t total();
+
+private:
+    const std::size_t start;
+};
+
+/**
+* Counts the calls to the global operator new made by all the threads while it is in scope, e.g.
+* when handlers posted by one thread run on another
+*/
+class GlobalAllocationCounter
+{
+public:
+    GlobalAllocationCounter();
+
+    /// @return the number of allocations made by all the threads since construction
+    std::size_t count() const;
+
+private:
+    const std::size_t start;
+};
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/AsyncMutex.h"
+#include "exe4cpp/MockExecutor.h"
+
+#include <vector>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "AsyncMutex - " name
+
+TEST_CASE(SUITE("uncontended lock is posted to the executor"))
+{
+    const auto executor = std::make_shared<MockExecutor>();
+    AsyncMutex mutex;
+
+    bool locked = false;
+    mutex.async_lock(executor, [&]() { locked = true; });
+
+    REQUIRE(mutex.is_locked());
+    REQUIRE_FALSE(mutex.try_lock());
+    REQUIRE(executor->run_many() == 1);
+    REQUIRE(locked);
+
+    mutex.unlock();
+    REQUIRE_FALSE(mutex.is_locked());
+    REQUIRE(mutex.try_lock());
+}
+
+TEST_CASE(SUITE("waiters are resumed in order on their own executor"))
+{
+    const auto first = std::make_shared<MockExecutor>();
+    const auto second = std::make_shared<MockExecutor>();
+    AsyncMutex mutex;
+
+    std::vector<int> order;
+    REQUIRE(mutex.try_lock());
+    mutex.async_lock(first, [&]() { order.push_back(1); });
+    mutex.async_lock(second, [&]() { order.push_back(2); });
+
+    REQUIRE(first->run_many() == 0);
+    REQUIRE(second->run_many() == 0);
+
+    mutex.unlock();
+    REQUIRE(second->run_many() == 0);
+    REQUIRE(first->run_many() == 1);
+
+    mutex.unlock();
+    REQUIRE(second->run_many() == 1);
+
+    REQUIRE(order == std::vector<int>({ 1, 2 }));
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/AsyncSemaphore.h"
+#include "exe4cpp/MockExecutor.h"
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "AsyncSemaphore - " name
+
+namespace
+{
+    // thread-safe executor that is run manually by its owning thread
+    class LockedExecutor final : public IExecutor
+    {
+    public:
+        Timer start(const duration_t&, const action_t&) override
+        {
+            return Timer{};
+        }
+
+        Timer start(const steady_time_t&, const action_t&) override
+        {
+            return Timer{};
+        }
+
+        void post(const action_t& action) override
+        {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            this->actions.push_back(action);
+        }
+
+        steady_time_t get_time() override
+        {
+            return steady_time_t{};
+        }
+
+        bool run_one()
+        {
+            action_t action;
+            {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                if (this->actions.empty())
+                {
+                    return false;
+                }
+                action = std::move(this->actions.front());
+                this->actions.pop_front();
+            }
+            action();
+            return true;
+        }
+
+    private:
+        std::mutex mutex;
+        std::deque<action_t> actions;
+    };
+}
+
+TEST_CASE(SUITE("permits are acquired without waiting until exhausted"))
+{
+    AsyncSemaphore semaphore(2);
+
+    REQUIRE(semaphore.try_acquire());
+    REQUIRE(semaphore.try_acquire());
+    REQUIRE_FALSE(semaphore.try_acquire());
+
+    semaphore.release();
+    REQUIRE(semaphore.try_acquire());
+}
+
+TEST_CASE(SUITE("a waiter is resumed when a permit is released"))
+{
+    const auto executor = std::make_shared<MockExecutor>();
+    AsyncSemaphore semaphore(1);
+
+    int count = 0;
+    auto increment = [&]() { ++count; };
+
+    semaphore.async_acquire(executor, increment);
+    semaphore.async_acquire(executor, increment);
+    REQUIRE(semaphore.available() == -1);
+
+    REQUIRE(executor->run_many() == 1);
+    REQUIRE(count == 1);
+
+    semaphore.release();
+    REQUIRE(executor->run_many() == 1);
+    REQUIRE(count == 2);
+    REQUIRE(semaphore.available() == 0);
+}
+
+TEST_CASE(SUITE("concurrent acquire and release never lose a waiter"))
+{
+    const int NUM_THREAD = 4;
+    const int NUM_OPS = 10000;
+
+    AsyncSemaphore semaphore(1);
+
+    std::vector<std::thread> threads;
+    std::vector<std::shared_ptr<LockedExecutor>> executors;
+    std::vector<int> counts(NUM_THREAD, 0);
+    for (int t = 0; t < NUM_THREAD; ++t)
+    {
+        executors.push_back(std::make_shared<LockedExecutor>());
+    }
+
+    for (int t = 0; t < NUM_THREAD; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            auto& executor = executors[t];
+            auto& count = counts[t];
+            for (int i = 0; i < NUM_OPS; ++i)
+            {
+                semaphore.async_acquire(executor, [&]() { ++count; semaphore.release(); });
+                while (!executor->run_one())
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto count : counts)
+    {
+        REQUIRE(count == NUM_OPS);
+    }
+    REQUIRE(semaphore.available() == 1);
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/BoundedQueue.h"
+
+#include <thread>
+#include <vector>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "BoundedQueue - " name
+
+TEST_CASE(SUITE("capacity is rounded up to a power of two"))
+{
+    REQUIRE(BoundedQueue<int>(5).capacity() == 8);
+    REQUIRE(BoundedQueue<int>(1).capacity() == 2);
+}
+
+TEST_CASE(SUITE("push fails when full and pop fails when empty"))
+{
+    BoundedQueue<int> queue(2);
+
+    REQUIRE(queue.try_push(1));
+    REQUIRE(queue.try_push(2));
+    REQUIRE_FALSE(queue.try_push(3));
+    REQUIRE(queue.size_approx() == 2);
+
+    int value = 0;
+    REQUIRE(queue.try_pop(value));
+    REQUIRE(value == 1);
+    REQUIRE(queue.try_pop(value));
+    REQUIRE(value == 2);
+    REQUIRE_FALSE(queue.try_pop(value));
+}
+
+TEST_CASE(SUITE("every item is received exactly once with concurrent producers and consumers"))
+{
+    const int NUM_PRODUCER = 4;
+    const int NUM_CONSUMER = 4;
+    const int NUM_ITEMS = 10000;
+
+    BoundedQueue<int> queue(64);
+    std::vector<std::atomic<int>> received(NUM_PRODUCER * NUM_ITEMS);
+    std::atomic<int> num_received{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < NUM_PRODUCER; ++p)
+    {
+        threads.emplace_back([&queue, p]()
+        {
+            for (int i = 0; i < NUM_ITEMS; ++i)
+            {
+                while (!queue.try_push(p * NUM_ITEMS + i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < NUM_CONSUMER; ++c)
+    {
+        threads.emplace_back([&]()
+        {
+            int value;
+            while (num_received.load() < NUM_PRODUCER * NUM_ITEMS)
+            {
+                if (queue.try_pop(value))
+                {
+                    ++received[value];
+                    ++num_received;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto& count : received)
+    {
+        REQUIRE(count.load() == 1);
+    }
+}
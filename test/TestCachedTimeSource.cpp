@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/CachedTimeSource.h"
+
+#include <thread>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "CachedTimeSource - " name
+
+namespace
+{
+    class CountingTimeSource final : public ISteadyTimeSource
+    {
+    public:
+        virtual steady_time_t get_time() override
+        {
+            ++this->num_reads;
+            return steady_time_t(std::chrono::seconds(this->num_reads));
+        }
+
+        int num_reads = 0;
+    };
+}
+
+TEST_CASE(SUITE("reads the underlying clock once until invalidated"))
+{
+    const auto source = std::make_shared<CountingTimeSource>();
+    CachedTimeSource cache{source};
+
+    REQUIRE(cache.get_time() == steady_time_t(std::chrono::seconds(1)));
+    REQUIRE(cache.get_time() == steady_time_t(std::chrono::seconds(1)));
+    REQUIRE(source->num_reads == 1);
+
+    cache.invalidate();
+
+    REQUIRE(cache.get_time() == steady_time_t(std::chrono::seconds(2)));
+    REQUIRE(cache.get_time() == steady_time_t(std::chrono::seconds(2)));
+    REQUIRE(source->num_reads == 2);
+}
+
+TEST_CASE(SUITE("defaults to steady_clock"))
+{
+    CachedTimeSource cache;
+
+    const auto before = std::chrono::steady_clock::now();
+    const auto time = cache.get_time();
+    REQUIRE(before <= time);
+    REQUIRE(time <= std::chrono::steady_clock::now());
+}
+
+TEST_CASE(SUITE("each thread has its own cached timestamp"))
+{
+    const auto source = std::make_shared<CountingTimeSource>();
+    CachedTimeSource cache{source};
+
+    REQUIRE(cache.get_time() == steady_time_t(std::chrono::seconds(1)));
+
+    steady_time_t other_times[2];
+    std::thread other([&]()
+    {
+        other_times[0] = cache.get_time();
+        cache.invalidate();
+        other_times[1] = cache.get_time();
+    });
+    other.join();
+
+    // the timestamp of the main thread is not shared
+    REQUIRE(other_times[0] == steady_time_t(std::chrono::seconds(2)));
+    REQUIRE(other_times[1] == steady_time_t(std::chrono::seconds(3)));
+
+    // an invalidation or a clock read on another thread does not touch this thread's timestamp
+    REQUIRE(cache.get_time() == steady_time_t(std::chrono::seconds(1)));
+    cache.invalidate();
+    REQUIRE(cache.get_time() == steady_time_t(std::chrono::seconds(4)));
+}
+
+TEST_CASE(SUITE("sources do not share their timestamps"))
+{
+    const auto source = std::make_shared<CountingTimeSource>();
+    CachedTimeSource first{source};
+    CachedTimeSource second{source};
+
+    REQUIRE(first.get_time() == steady_time_t(std::chrono::seconds(1)));
+    REQUIRE(second.get_time() == steady_time_t(std::chrono::seconds(2)));
+    REQUIRE(first.get_time() == steady_time_t(std::chrono::seconds(3)));
+}
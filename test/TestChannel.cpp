@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/Channel.h"
+#include "exe4cpp/MockExecutor.h"
+
+#include <vector>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "Channel - " name
+
+TEST_CASE(SUITE("try_send fails when the channel is full"))
+{
+    const auto channel = Channel<int>::create(2);
+
+    REQUIRE(channel->try_send(1));
+    REQUIRE(channel->try_send(2));
+    REQUIRE_FALSE(channel->try_send(3));
+
+    int value = 0;
+    REQUIRE(channel->try_receive(value));
+    REQUIRE(value == 1);
+    REQUIRE(channel->try_send(3));
+}
+
+TEST_CASE(SUITE("async_receive waits for a message"))
+{
+    const auto consumer = std::make_shared<MockExecutor>();
+    const auto channel = Channel<int>::create(4);
+
+    std::vector<int> received;
+    channel->async_receive(consumer, [&](int&& value) { received.push_back(value); });
+
+    REQUIRE(consumer->run_many() == 0);
+
+    REQUIRE(channel->try_send(42));
+    REQUIRE(received.empty());
+    REQUIRE(consumer->run_many() == 1);
+    REQUIRE(received == std::vector<int>({ 42 }));
+}
+
+TEST_CASE(SUITE("async_send waits for room when the channel is full"))
+{
+    const auto producer = std::make_shared<MockExecutor>();
+    const auto channel = Channel<int>::create(2);
+
+    int num_sent = 0;
+    auto on_sent = [&]() { ++num_sent; };
+
+    channel->async_send(producer, 1, on_sent);
+    channel->async_send(producer, 2, on_sent);
+    channel->async_send(producer, 3, on_sent);
+    producer->run_many();
+    REQUIRE(num_sent == 2);
+
+    int value = 0;
+    REQUIRE(channel->try_receive(value));
+    REQUIRE(value == 1);
+
+    producer->run_many();
+    REQUIRE(num_sent == 3);
+    REQUIRE(channel->try_receive(value));
+    REQUIRE(value == 2);
+    REQUIRE(channel->try_receive(value));
+    REQUIRE(value == 3);
+}
+
+TEST_CASE(SUITE("async_receive delivers a batch of messages in a single action"))
+{
+    const auto consumer = std::make_shared<MockExecutor>();
+    const auto channel = Channel<int>::create(8);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        REQUIRE(channel->try_send(i));
+    }
+
+    std::vector<int> received;
+    channel->async_receive(consumer, [&](int&& value) { received.push_back(value); }, 3);
+
+    REQUIRE(consumer->run_many() == 1);
+    REQUIRE(received == std::vector<int>({ 0, 1, 2 }));
+    REQUIRE(channel->size_approx() == 2);
+}
+
+TEST_CASE(SUITE("later messages do not overtake a parked message"))
+{
+    const auto producer = std::make_shared<MockExecutor>();
+    const auto channel = Channel<int>::create(2);
+
+    channel->async_send(producer, 1);
+    channel->async_send(producer, 2);
+    channel->async_send(producer, 3);
+
+    int value = 0;
+    REQUIRE(channel->try_receive(value));
+    REQUIRE(value == 1);
+
+    // the retry of 3 is pending, 4 must wait behind it
+    channel->async_send(producer, 4);
+    REQUIRE_FALSE(channel->try_send(5));
+    producer->run_many();
+
+    std::vector<int> received;
+    while (channel->try_receive(value))
+    {
+        received.push_back(value);
+        producer->run_many();
+    }
+
+    REQUIRE(received == std::vector<int>({ 2, 3, 4 }));
+    REQUIRE(channel->try_send(5));
+}
+
+TEST_CASE(SUITE("async_send rejects messages past the parked limit"))
+{
+    const auto producer = std::make_shared<MockExecutor>();
+    const auto channel = Channel<int>::create(2, 2);
+
+    int num_sent = 0;
+    auto on_sent = [&]() { ++num_sent; };
+
+    REQUIRE(channel->async_send(producer, 1, on_sent));
+    REQUIRE(channel->async_send(producer, 2, on_sent));
+    REQUIRE(channel->async_send(producer, 3, on_sent));
+    REQUIRE(channel->async_send(producer, 4, on_sent));
+    REQUIRE_FALSE(channel->async_send(producer, 5, on_sent));
+    REQUIRE(channel->num_parked() == 2);
+    producer->run_many();
+    REQUIRE(num_sent == 2);
+
+    // the retry of 3 is pending and still counts as parked
+    int value = 0;
+    REQUIRE(channel->try_receive(value));
+    REQUIRE(channel->num_parked() == 2);
+    REQUIRE_FALSE(channel->async_send(producer, 6, on_sent));
+
+    producer->run_many();
+    REQUIRE(num_sent == 3);
+    REQUIRE(channel->num_parked() == 1);
+    REQUIRE(channel->async_send(producer, 7, on_sent));
+
+    std::vector<int> received;
+    while (channel->try_receive(value))
+    {
+        received.push_back(value);
+        producer->run_many();
+    }
+
+    REQUIRE(received == std::vector<int>({ 2, 3, 4, 7 }));
+    REQUIRE(num_sent == 5);
+    REQUIRE(channel->num_parked() == 0);
+}
+
+TEST_CASE(SUITE("async_send parks any number of messages by default"))
+{
+    const auto producer = std::make_shared<MockExecutor>();
+    const auto channel = Channel<int>::create(2);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        REQUIRE(channel->async_send(producer, i));
+    }
+    REQUIRE(channel->num_parked() == 998);
+}
+
+TEST_CASE(SUITE("capacity is rounded up to a power of two"))
+{
+    REQUIRE(Channel<int>::create(3)->capacity() == 4);
+    REQUIRE(Channel<int>::create(4)->capacity() == 4);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/CoarseTimeSource.h"
+
+#include <thread>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "CoarseTimeSource - " name
+
+TEST_CASE(SUITE("is never ahead of steady_clock"))
+{
+    CoarseTimeSource source;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        const auto time = source.get_time();
+        REQUIRE(time <= std::chrono::steady_clock::now());
+    }
+}
+
+TEST_CASE(SUITE("advances once per tick"))
+{
+    CoarseTimeSource source;
+
+    const auto start = source.get_time();
+    std::this_thread::sleep_for(2 * source.precision() + std::chrono::milliseconds(1));
+    REQUIRE(start < source.get_time());
+}
+
+TEST_CASE(SUITE("is monotonic"))
+{
+    CoarseTimeSource source;
+
+    auto last = source.get_time();
+    for (int i = 0; i < 1000; ++i)
+    {
+        const auto time = source.get_time();
+        REQUIRE(last <= time);
+        last = time;
+    }
+}
+
+#if defined(__linux__)
+TEST_CASE(SUITE("uses the coarse clock on Linux"))
+{
+    CoarseTimeSource source;
+
+    REQUIRE(source.is_coarse_clock());
+    REQUIRE(source.precision() > duration_t::zero());
+}
+#endif
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/DeadlineExecutor.h"
+#include "exe4cpp/MockExecutor.h"
+
+#include <stdexcept>
+#include <vector>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "DeadlineExecutor - " name
+
+TEST_CASE(SUITE("events are executed in deadline order"))
+{
+    const auto mock = std::make_shared<MockExecutor>();
+    const auto executor = DeadlineExecutor::create(mock, std::chrono::seconds(10));
+
+    const auto now = mock->get_time();
+    std::vector<int> order;
+    executor->post(now + std::chrono::seconds(3), [&]() { order.push_back(3); });
+    executor->post(now + std::chrono::seconds(1), [&]() { order.push_back(1); });
+    executor->post([&]() { order.push_back(10); });
+    executor->post(now + std::chrono::seconds(2), [&]() { order.push_back(2); });
+    executor->post(now + std::chrono::seconds(1), [&]() { order.push_back(4); });
+
+    mock->run_many();
+
+    REQUIRE(order == std::vector<int>({ 1, 4, 2, 3, 10 }));
+}
+
+TEST_CASE(SUITE("expired events are dropped"))
+{
+    const auto mock = std::make_shared<MockExecutor>();
+    const auto executor = DeadlineExecutor::create(mock, std::chrono::seconds(10), ExpiredPolicy::drop);
+
+    const auto now = mock->get_time();
+    std::vector<int> order;
+    executor->post(now + std::chrono::seconds(1), [&]() { order.push_back(1); });
+    executor->post(now + std::chrono::seconds(5), [&]() { order.push_back(5); });
+
+    mock->add_time(std::chrono::seconds(2));
+    mock->run_many();
+
+    REQUIRE(order == std::vector<int>({ 5 }));
+    REQUIRE(executor->num_expired() == 1);
+}
+
+TEST_CASE(SUITE("expired events are redirected"))
+{
+    const auto mock = std::make_shared<MockExecutor>();
+    const auto fallback = std::make_shared<MockExecutor>();
+    const auto executor = DeadlineExecutor::create(mock, std::chrono::seconds(10), ExpiredPolicy::redirect, fallback);
+
+    bool executed = false;
+    executor->post(mock->get_time(), [&]() { executed = true; });
+
+    mock->add_time(std::chrono::seconds(1));
+    mock->run_many();
+    REQUIRE_FALSE(executed);
+
+    REQUIRE(fallback->run_many() == 1);
+    REQUIRE(executed);
+}
+
+TEST_CASE(SUITE("expired timers are queued with the default deadline"))
+{
+    const auto mock = std::make_shared<MockExecutor>();
+    const auto executor = DeadlineExecutor::create(mock, std::chrono::seconds(1), ExpiredPolicy::drop);
+
+    int count = 0;
+    executor->start(std::chrono::seconds(5), [&]() { ++count; });
+
+    mock->advance_time(std::chrono::seconds(5));
+    mock->run_many();
+
+    REQUIRE(count == 1);
+}
+
+TEST_CASE(SUITE("the executor lives until its queued events have run"))
+{
+    const auto mock = std::make_shared<MockExecutor>();
+    auto executor = DeadlineExecutor::create(mock, std::chrono::seconds(1));
+    const std::weak_ptr<DeadlineExecutor> weak = executor;
+
+    int count = 0;
+    executor->post([&]() { ++count; });
+    executor.reset();
+    REQUIRE_FALSE(weak.expired());
+
+    REQUIRE(mock->run_many() == 1);
+    REQUIRE(count == 1);
+    REQUIRE(weak.expired());
+}
+
+TEST_CASE(SUITE("a throwing event does not stop the dispatch"))
+{
+    const auto mock = std::make_shared<MockExecutor>();
+    const auto executor = DeadlineExecutor::create(mock, std::chrono::seconds(10));
+
+    const auto now = mock->get_time();
+    std::vector<int> order;
+    executor->post(now + std::chrono::seconds(1), []() { throw std::runtime_error("event failed"); });
+    executor->post(now + std::chrono::seconds(2), [&]() { order.push_back(2); });
+
+    REQUIRE_THROWS_AS(mock->run_many(), std::runtime_error);
+    mock->run_many();
+    REQUIRE(order == std::vector<int>({ 2 }));
+
+    executor->post(now + std::chrono::seconds(3), [&]() { order.push_back(3); });
+    mock->run_many();
+    REQUIRE(order == std::vector<int>({ 2, 3 }));
+}
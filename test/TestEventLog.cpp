@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/EventLog.h"
+
+#include <sstream>
+
+using namespace exe4cpp;
+using namespace std::chrono;
+
+#define SUITE(name) "EventLog - " name
+
+namespace
+{
+    RecordedEvent make_event(EventKind kind, duration_t time, uint64_t id, uint32_t handler = 0, duration_t delay = duration_t::zero())
+    {
+        RecordedEvent event;
+        event.kind = kind;
+        event.time = time;
+        event.id = id;
+        event.handler = handler;
+        event.delay = delay;
+        return event;
+    }
+}
+
+TEST_CASE(SUITE("events survive a round trip"))
+{
+    std::stringstream stream;
+    {
+        EventLogWriter writer{stream};
+        const auto first = writer.intern("first");
+        const auto second = writer.intern("second");
+        REQUIRE(writer.intern("first") == first);
+
+        writer.write(make_event(EventKind::post, milliseconds(0), 0, first));
+        writer.write(make_event(EventKind::start, milliseconds(2), 1, second, milliseconds(10)));
+        writer.write(make_event(EventKind::run, milliseconds(3), 0));
+        // times recorded by different threads may go backwards
+        writer.write(make_event(EventKind::cancel, microseconds(2500), 1));
+        writer.write(make_event(EventKind::complete, hours(30), 0));
+    }
+
+    const auto log = EventLogReader::read(stream);
+
+    REQUIRE(log.handlers == std::vector<std::string>{ "first", "second" });
+    REQUIRE(log.events.size() == 5);
+
+    REQUIRE(log.events[0].kind == EventKind::post);
+    REQUIRE(log.events[0].handler == 0);
+
+    REQUIRE(log.events[1].kind == EventKind::start);
+    REQUIRE(log.events[1].time == milliseconds(2));
+    REQUIRE(log.events[1].id == 1);
+    REQUIRE(log.events[1].handler == 1);
+    REQUIRE(log.events[1].delay == milliseconds(10));
+
+    REQUIRE(log.events[2].kind == EventKind::run);
+    REQUIRE(log.events[3].kind == EventKind::cancel);
+    REQUIRE(log.events[3].time == microseconds(2500));
+    REQUIRE(log.events[4].kind == EventKind::complete);
+    REQUIRE(log.events[4].time == hours(30));
+}
+
+TEST_CASE(SUITE("records are compact"))
+{
+    std::stringstream stream;
+    EventLogWriter writer{stream};
+    const auto handler = writer.intern("handler");
+    const auto header = stream.str().size();
+
+    for (uint64_t i = 0; i < 1000; ++i)
+    {
+        writer.write(make_event(EventKind::post, microseconds(i * 10), i, handler));
+    }
+
+    // kind, time delta, id and handler
+    REQUIRE(stream.str().size() - header <= 1000 * 7);
+}
+
+TEST_CASE(SUITE("invalid logs are rejected"))
+{
+    std::stringstream empty;
+    REQUIRE_THROWS_AS(EventLogReader::read(empty), std::runtime_error);
+
+    std::stringstream other{"not a log at all"};
+    REQUIRE_THROWS_AS(EventLogReader::read(other), std::runtime_error);
+
+    std::stringstream stream;
+    {
+        EventLogWriter writer{stream};
+        writer.write(make_event(EventKind::post, milliseconds(1), 0, writer.intern("handler")));
+    }
+    const auto bytes = stream.str();
+
+    std::stringstream truncated{bytes.substr(0, bytes.size() - 1)};
+    REQUIRE_THROWS_AS(EventLogReader::read(truncated), std::runtime_error);
+
+    std::stringstream bad_kind{bytes + '\x7F'};
+    REQUIRE_THROWS_AS(EventLogReader::read(bad_kind), std::runtime_error);
+}
+
+TEST_CASE(SUITE("name lengths are checked before the name is read"))
+{
+    std::stringstream stream;
+    {
+        EventLogWriter writer{stream};
+    }
+    const auto header = stream.str();
+
+    // a name record claiming 2^63 bytes
+    std::stringstream huge{header + '\0' + std::string(9, '\xFF') + '\x01' + "name"};
+    REQUIRE_THROWS_AS(EventLogReader::read(huge), std::runtime_error);
+
+    // a name record claiming 60000 bytes of a 4 byte input
+    std::stringstream short_name{header + '\0' + "\xE0\xD4\x03" + "name"};
+    REQUIRE_THROWS_AS(EventLogReader::read(short_name), std::runtime_error);
+
+    EventLogWriter writer{stream};
+    REQUIRE_THROWS_AS(writer.intern(std::string(EventLogWriter::max_name_size + 1, 'x')), std::invalid_argument);
+}
+
+TEST_CASE(SUITE("durations pair the runs and completions of a handler"))
+{
+    EventLog log;
+    log.handlers = { "fast", "slow" };
+    log.events = {
+        make_event(EventKind::post, milliseconds(0), 0, 0),
+        make_event(EventKind::post, milliseconds(0), 1, 1),
+        make_event(EventKind::start, milliseconds(0), 2, 0, milliseconds(5)),
+        make_event(EventKind::run, milliseconds(1), 0),
+        make_event(EventKind::complete, milliseconds(2), 0),
+        make_event(EventKind::run, milliseconds(2), 1),
+        make_event(EventKind::complete, milliseconds(9), 1),
+        make_event(EventKind::run, milliseconds(9), 2),
+        make_event(EventKind::complete, milliseconds(12), 2),
+    };
+
+    REQUIRE(log.durations("fast") == std::vector<duration_t>{ milliseconds(1), milliseconds(3) });
+    REQUIRE(log.durations("slow") == std::vector<duration_t>{ milliseconds(7) });
+    REQUIRE(log.durations("unknown").empty());
+}
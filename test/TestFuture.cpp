@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/Future.h"
+#include "exe4cpp/MockExecutor.h"
+
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "Future - " name
+
+TEST_CASE(SUITE("continuations are posted to the executor"))
+{
+    const auto executor = std::make_shared<MockExecutor>();
+
+    Promise<int> promise;
+    auto future = promise.get_future().then(executor, [](const int& value) { return std::to_string(value * 2); });
+
+    std::string result;
+    future.then(executor, [&](const std::string& value) { result = value; });
+
+    REQUIRE(executor->run_many() == 0);
+
+    promise.set_value(21);
+    REQUIRE_FALSE(future.is_ready());
+    REQUIRE(executor->run_many() == 2);
+    REQUIRE(future.is_ready());
+    REQUIRE(result == "42");
+}
+
+TEST_CASE(SUITE("continuation attached to a ready future is posted immediately"))
+{
+    const auto executor = std::make_shared<MockExecutor>();
+
+    int result = 0;
+    make_ready_future(7).then(executor, [&](const int& value) { result = value; });
+
+    REQUIRE(executor->run_many() == 1);
+    REQUIRE(result == 7);
+}
+
+TEST_CASE(SUITE("when_all is ready once every future is ready"))
+{
+    Promise<int> first;
+    Promise<int> second;
+
+    auto all = when_all(std::vector<Future<int>>{ first.get_future(), second.get_future() });
+
+    second.set_value(2);
+    REQUIRE_FALSE(all.is_ready());
+    first.set_value(1);
+    REQUIRE(all.is_ready());
+    REQUIRE(all.get() == std::vector<int>({ 1, 2 }));
+}
+
+TEST_CASE(SUITE("when_any is ready with the first future that is ready"))
+{
+    Promise<int> first;
+    Promise<int> second;
+
+    auto any = when_any(std::vector<Future<int>>{ first.get_future(), second.get_future() });
+
+    REQUIRE_FALSE(any.is_ready());
+    second.set_value(2);
+    REQUIRE(any.is_ready());
+    first.set_value(1);
+    REQUIRE(any.get().first == 1);
+    REQUIRE(any.get().second == 2);
+}
+
+TEST_CASE(SUITE("void continuations can be chained and joined"))
+{
+    const auto executor = std::make_shared<MockExecutor>();
+
+    Promise<void> start;
+    std::vector<int> steps;
+
+    // a future supports a single continuation, so each stage is consumed once
+    auto first = start.get_future().then(executor, [&]() { steps.push_back(1); });
+    auto second = first.then(executor, [&]() { steps.push_back(2); });
+    auto other = make_ready_future().then(executor, [&]() { steps.push_back(0); });
+    auto last = make_ready_future().then(executor, [&]() { steps.push_back(3); });
+
+    auto all = when_all(std::vector<Future<void>>{ second, other });
+    auto any = when_any(std::vector<Future<void>>{ all, last });
+
+    REQUIRE(executor->run_many() == 2);
+    REQUIRE(any.is_ready());
+    REQUIRE(any.get() == 1);
+    REQUIRE_FALSE(all.is_ready());
+
+    start.set_value();
+    REQUIRE(executor->run_many() == 2);
+    REQUIRE(all.is_ready());
+    REQUIRE_FALSE(all.has_exception());
+    REQUIRE(steps == std::vector<int>({ 0, 3, 1, 2 }));
+
+    auto value = make_ready_future().then(executor, []() { return 4; });
+    REQUIRE(executor->run_many() == 1);
+    REQUIRE(value.get() == 4);
+}
+
+TEST_CASE(SUITE("exceptions skip the continuations and reach the end of the chain"))
+{
+    const auto executor = std::make_shared<MockExecutor>();
+
+    Promise<int> promise;
+    bool is_skipped = true;
+    auto failed = promise.get_future()
+        .then(executor, [](const int&) -> int { throw std::runtime_error("failed"); })
+        .then(executor, [&](const int& value) { is_skipped = false; return value; });
+
+    auto all = when_all(std::vector<Future<int>>{ failed, make_ready_future(1) });
+
+    promise.set_value(1);
+    executor->run_many();
+
+    REQUIRE(is_skipped);
+    REQUIRE(failed.has_exception());
+    REQUIRE_THROWS_AS(failed.get(), std::runtime_error);
+    REQUIRE(all.has_exception());
+    REQUIRE_THROWS_AS(all.get(), std::runtime_error);
+}
+
+TEST_CASE(SUITE("a promise destroyed without a value breaks its future"))
+{
+    const auto executor = std::make_shared<MockExecutor>();
+    const auto token = std::make_shared<int>(0);
+
+    Future<int> next;
+    {
+        Promise<int> promise;
+        next = promise.get_future().then(executor, [token](const int& value) { return value; });
+        REQUIRE(token.use_count() == 2);
+    }
+
+    // the continuation was released without being run
+    REQUIRE(token.use_count() == 1);
+    REQUIRE(executor->run_many() == 0);
+    REQUIRE(next.has_exception());
+
+    try
+    {
+        next.get();
+        FAIL("expected a broken promise");
+    }
+    catch (const std::future_error& ex)
+    {
+        REQUIRE(ex.code() == std::future_errc::broken_promise);
+    }
+}
+
+TEST_CASE(SUITE("futures that never complete do not keep themselves alive"))
+{
+    auto state = std::make_shared<FutureState<int>>();
+    const std::weak_ptr<FutureState<int>> weak = state;
+    {
+        Promise<int> winner;
+        auto any = when_any(std::vector<Future<int>>{ winner.get_future(), Future<int>{state} });
+        state.reset();
+
+        winner.set_value(1);
+        REQUIRE(any.get().first == 0);
+    }
+
+    REQUIRE(weak.expired());
+}
+
+TEST_CASE(SUITE("a second continuation is rejected"))
+{
+    const auto executor = std::make_shared<MockExecutor>();
+
+    Promise<int> promise;
+    auto future = promise.get_future();
+    auto first = future.then(executor, [](const int& value) { return value; });
+
+    try
+    {
+        future.then(executor, [](const int& value) { return value; });
+        FAIL("a second then() must throw");
+    }
+    catch (const std::future_error& ex)
+    {
+        REQUIRE(ex.code() == std::future_errc::future_already_retrieved);
+    }
+
+    // the first chain still completes
+    promise.set_value(3);
+    REQUIRE(executor->run_many() == 1);
+    REQUIRE(first.is_ready());
+    REQUIRE(first.get() == 3);
+}
+
+TEST_CASE(SUITE("when_all collects bool values completed from several threads"))
+{
+    const size_t NUM_THREADS = 4;
+    const size_t NUM_FUTURES = 256;
+
+    for (int iteration = 0; iteration < 20; ++iteration)
+    {
+        std::vector<Promise<bool>> promises(NUM_FUTURES);
+        std::vector<Future<bool>> futures;
+        for (auto& promise : promises)
+        {
+            futures.push_back(promise.get_future());
+        }
+        auto all = when_all(futures);
+
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < NUM_THREADS; ++t)
+        {
+            threads.emplace_back([&promises, t]()
+            {
+                for (size_t i = t; i < NUM_FUTURES; i += NUM_THREADS)
+                {
+                    promises[i].set_value(i % 3 != 0);
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        REQUIRE(all.is_ready());
+        const auto& values = all.get();
+        REQUIRE(values.size() == NUM_FUTURES);
+        for (size_t i = 0; i < NUM_FUTURES; ++i)
+        {
+            REQUIRE(values[i] == (i % 3 != 0));
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/HandlerCost.h"
+
+#include <random>
+
+using namespace exe4cpp;
+using namespace std::chrono;
+
+#define SUITE(name) "HandlerCost - " name
+
+TEST_CASE(SUITE("fixed cost"))
+{
+    const auto model = HandlerCost::fixed(milliseconds(3));
+    REQUIRE(model("") == milliseconds(3));
+    REQUIRE(model("") == milliseconds(3));
+}
+
+TEST_CASE(SUITE("sampled costs are reproducible and follow the distribution"))
+{
+    const auto model = HandlerCost::sampled(std::exponential_distribution<double>{1.0}, milliseconds(1), 7);
+    const auto copy = HandlerCost::sampled(std::exponential_distribution<double>{1.0}, milliseconds(1), 7);
+
+    duration_t total = duration_t::zero();
+    for (int i = 0; i < 10000; ++i)
+    {
+        const auto cost = model("");
+        REQUIRE(cost == copy(""));
+        REQUIRE(cost >= duration_t::zero());
+        total += cost;
+    }
+
+    const auto mean = duration_cast<microseconds>(total / 10000);
+    REQUIRE(mean > microseconds(900));
+    REQUIRE(mean < microseconds(1100));
+}
+
+TEST_CASE(SUITE("negative samples count as zero"))
+{
+    const auto model = HandlerCost::sampled(std::normal_distribution<double>{-10.0, 1.0}, milliseconds(1));
+    for (int i = 0; i < 100; ++i)
+    {
+        REQUIRE(model("") == duration_t::zero());
+    }
+}
+
+TEST_CASE(SUITE("empirical costs are picked among the samples"))
+{
+    const auto model = HandlerCost::empirical({ milliseconds(1), milliseconds(5) }, 3);
+
+    bool seen[2] = { false, false };
+    for (int i = 0; i < 100; ++i)
+    {
+        const auto cost = model("");
+        REQUIRE((cost == milliseconds(1) || cost == milliseconds(5)));
+        seen[cost == milliseconds(5)] = true;
+    }
+    REQUIRE(seen[0]);
+    REQUIRE(seen[1]);
+}
+
+TEST_CASE(SUITE("costs by tag"))
+{
+    const auto model = HandlerCost::by_tag({ { "read", HandlerCost::fixed(milliseconds(2)) } }, HandlerCost::fixed(milliseconds(7)));
+    REQUIRE(model("read") == milliseconds(2));
+    REQUIRE(model("write") == milliseconds(7));
+    REQUIRE(model("") == milliseconds(7));
+
+    const auto without_default = HandlerCost::by_tag({ { "read", HandlerCost::fixed(milliseconds(2)) } });
+    REQUIRE(without_default("write") == duration_t::zero());
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/InterleavingExplorer.h"
+
+#include <memory>
+#include <set>
+#include <stdexcept>
+
+using namespace exe4cpp;
+using namespace std::chrono;
+
+#define SUITE(name) "InterleavingExplorer - " name
+
+namespace
+{
+    // two strands posting two handlers each, optionally touching a common resource
+    InterleavingExplorer::scenario_t two_by_two(std::set<schedule_t>& orders, bool is_shared)
+    {
+        return [&orders, is_shared](ExplorationRun& run)
+        {
+            const auto order = std::make_shared<schedule_t>();
+            for (size_t i = 0; i < 2; ++i)
+            {
+                const auto strand = run.create_strand();
+                for (int j = 0; j < 2; ++j)
+                {
+                    strand->post([&run, order, i, is_shared]()
+                    {
+                        if (is_shared)
+                        {
+                            run.touch("shared");
+                        }
+                        order->push_back(i);
+                    });
+                }
+            }
+            run.add_check([&orders, order]() { orders.insert(*order); });
+        };
+    }
+
+    // each strand reads a balance in one handler and writes it back incremented in the next one
+    void lost_update(ExplorationRun& run)
+    {
+        const auto balance = std::make_shared<int>(0);
+        for (int i = 0; i < 2; ++i)
+        {
+            const auto strand = run.create_strand();
+            strand->post([&run, strand, balance]()
+            {
+                run.touch("balance");
+                const auto read = *balance;
+                strand->post([&run, balance, read]()
+                {
+                    run.touch("balance");
+                    *balance = read + 1;
+                });
+            });
+        }
+        run.add_check([balance]()
+        {
+            if (*balance != 2)
+            {
+                throw std::logic_error("lost update");
+            }
+        });
+    }
+}
+
+TEST_CASE(SUITE("enumerates every interleaving"))
+{
+    std::set<schedule_t> orders;
+    InterleavingExplorer explorer;
+    const auto result = explorer.explore_all(two_by_two(orders, false));
+
+    REQUIRE_FALSE(result.is_failed);
+    REQUIRE(result.is_exhaustive);
+    REQUIRE(result.num_runs == 6);
+    REQUIRE(result.num_pruned == 0);
+    REQUIRE(orders.size() == 6);
+}
+
+TEST_CASE(SUITE("reduction skips the reordering of independent handlers"))
+{
+    std::set<schedule_t> orders;
+    InterleavingExplorer explorer;
+    explorer.set_reduction(true);
+    const auto result = explorer.explore_all(two_by_two(orders, false));
+
+    REQUIRE(result.is_exhaustive);
+    REQUIRE(result.num_runs - result.num_pruned == 1);
+    REQUIRE(orders.size() == 1);
+}
+
+TEST_CASE(SUITE("reduction keeps the reordering of handlers touching the same resource"))
+{
+    std::set<schedule_t> orders;
+    InterleavingExplorer explorer;
+    explorer.set_reduction(true);
+    const auto result = explorer.explore_all(two_by_two(orders, true));
+
+    REQUIRE(result.is_exhaustive);
+    REQUIRE(result.num_runs - result.num_pruned == 6);
+    REQUIRE(orders.size() == 6);
+}
+
+TEST_CASE(SUITE("reduction keeps the order of posts to a common strand"))
+{
+    std::set<std::vector<int>> outcomes;
+    InterleavingExplorer explorer;
+    explorer.set_reduction(true);
+
+    const auto result = explorer.explore_all([&outcomes](ExplorationRun& run)
+    {
+        const auto target = run.create_strand();
+        const auto order = std::make_shared<std::vector<int>>();
+        for (int i = 0; i < 3; ++i)
+        {
+            run.create_strand()->post([target, order, i]()
+            {
+                target->post([order, i]() { order->push_back(i); });
+            });
+        }
+        run.add_check([&outcomes, order]() { outcomes.insert(*order); });
+    });
+
+    REQUIRE(result.is_exhaustive);
+    REQUIRE(outcomes.size() == 6);
+}
+
+TEST_CASE(SUITE("finds a failing interleaving and replays it"))
+{
+    InterleavingExplorer explorer;
+    explorer.set_reduction(true);
+    const auto result = explorer.explore_all(lost_update);
+
+    REQUIRE(result.is_failed);
+    REQUIRE(result.failure == "lost update");
+    REQUIRE(result.schedule.size() == 4);
+
+    const auto replayed = explorer.replay(lost_update, result.schedule);
+    REQUIRE(replayed.is_failed);
+    REQUIRE(replayed.schedule == result.schedule);
+
+    // the same handlers one strand after the other
+    const auto serial = explorer.replay(lost_update, schedule_t{ 0, 0, 1, 1 });
+    REQUIRE_FALSE(serial.is_failed);
+    REQUIRE(serial.schedule.empty());
+
+    REQUIRE_THROWS_AS(explorer.replay(lost_update, schedule_t{ 2 }), std::logic_error);
+}
+
+TEST_CASE(SUITE("random exploration is reproducible from the seed"))
+{
+    InterleavingExplorer explorer;
+    const auto first = explorer.explore_random(lost_update, 1000, 42);
+    const auto second = explorer.explore_random(lost_update, 1000, 42);
+
+    REQUIRE(first.is_failed);
+    REQUIRE(first.num_runs == second.num_runs);
+    REQUIRE(first.schedule == second.schedule);
+    REQUIRE(explorer.replay(lost_update, first.schedule).is_failed);
+
+    std::set<schedule_t> orders;
+    const auto passing = explorer.explore_random(two_by_two(orders, false), 200, 7);
+    REQUIRE_FALSE(passing.is_failed);
+    REQUIRE(passing.num_runs == 200);
+    REQUIRE(orders.size() == 6);
+}
+
+TEST_CASE(SUITE("timers expire once no handler is ready"))
+{
+    std::vector<std::pair<int, duration_t>> events;
+    InterleavingExplorer explorer;
+
+    const auto result = explorer.explore_all([&events](ExplorationRun& run)
+    {
+        events.clear();
+        const auto strand = run.create_strand();
+        const auto other = run.create_strand();
+        const auto start = run.get_time();
+
+        strand->start(milliseconds(10), [&events, &run, start]() { events.emplace_back(1, run.get_time() - start); });
+        strand->start(milliseconds(5), [&events, &run, start]() { events.emplace_back(0, run.get_time() - start); });
+        auto canceled = strand->start(milliseconds(1), [&events]() { events.emplace_back(-1, duration_t::zero()); });
+        other->post([canceled]() mutable { canceled.cancel(); });
+    });
+
+    REQUIRE(result.is_exhaustive);
+    REQUIRE(result.num_runs == 1);
+    REQUIRE(events == std::vector<std::pair<int, duration_t>>{ { 0, milliseconds(5) }, { 1, milliseconds(10) } });
+}
+
+TEST_CASE(SUITE("the number of runs and steps can be bounded"))
+{
+    std::set<schedule_t> orders;
+    InterleavingExplorer explorer;
+    const auto result = explorer.explore_all(two_by_two(orders, false), 4);
+    REQUIRE(result.num_runs == 4);
+    REQUIRE_FALSE(result.is_exhaustive);
+
+    size_t num_handlers = 0;
+    explorer.set_max_steps(50);
+    const auto endless = explorer.explore_random([&num_handlers](ExplorationRun& run)
+    {
+        // a handler that reposts itself forever
+        const auto strand = run.create_strand();
+        const auto handler = std::make_shared<action_t>();
+        *handler = [&num_handlers, strand, self = handler.get()]()
+        {
+            ++num_handlers;
+            strand->post([self]() { (*self)(); });
+        };
+        strand->post(*handler);
+        run.add_check([handler]() {});
+    }, 1, 0);
+
+    REQUIRE_FALSE(endless.is_failed);
+    REQUIRE(num_handlers == 50);
+}
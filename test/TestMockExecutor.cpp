@@ -26,6 +26,9 @@
 
 #include "exe4cpp/MockExecutor.h"
 
+#include <memory>
+#include <vector>
+
 using namespace exe4cpp;
 
 #define SUITE(name) "MockExecutor - " name
@@ -35,3 +38,177 @@ TEST_CASE(SUITE("can be constructed"))
     MockExecutor executor;
 }
 
+
+TEST_CASE(SUITE("timers with overlapping slack windows expire together"))
+{
+    using std::chrono::milliseconds;
+
+    MockExecutor executor;
+    executor.add_time(milliseconds(1));
+
+    size_t count = 0;
+    const action_t increment = [&]() { ++count; };
+
+    auto t1 = executor.start(milliseconds(10), increment, milliseconds(10));
+    auto t2 = executor.start(milliseconds(12), increment, milliseconds(10));
+    executor.start(milliseconds(5), increment, duration_t::zero());
+
+    REQUIRE(t1.expires_at() == t2.expires_at());
+    REQUIRE(t1.expires_at() >= executor.get_time() + milliseconds(12));
+    REQUIRE(t1.expires_at() <= executor.get_time() + milliseconds(20));
+
+    REQUIRE(executor.advance_time(milliseconds(5)) == 1);
+    REQUIRE(executor.run_many() == 1);
+    REQUIRE(executor.advance_to_next_timer());
+    REQUIRE(executor.run_many() == 2);
+    REQUIRE(count == 3);
+}
+
+TEST_CASE(SUITE("expired timers are queued in deadline order"))
+{
+    using std::chrono::milliseconds;
+
+    MockExecutor executor;
+
+    std::vector<int> order;
+    executor.start(milliseconds(30), [&]() { order.push_back(30); });
+    executor.start(milliseconds(10), [&]() { order.push_back(10); });
+    executor.start(milliseconds(40), [&]() { order.push_back(40); });
+    executor.start(milliseconds(20), [&]() { order.push_back(20); });
+    executor.start(milliseconds(10), [&]() { order.push_back(11); });
+
+    REQUIRE(executor.advance_time(milliseconds(30)) == 4);
+    REQUIRE(executor.run_many() == 4);
+    REQUIRE(order == std::vector<int>({10, 11, 20, 30}));
+    REQUIRE(executor.num_pending_timers() == 1);
+}
+
+TEST_CASE(SUITE("handlers are charged the virtual time of the cost model"))
+{
+    using std::chrono::milliseconds;
+
+    MockExecutor executor;
+    executor.set_cost_model(HandlerCost::fixed(milliseconds(5)));
+    const auto start = executor.get_time();
+
+    std::vector<steady_time_t> times;
+    executor.post([&]() { times.push_back(executor.get_time()); });
+    executor.post([&]() { times.push_back(executor.get_time()); });
+    executor.start(milliseconds(7), [&]() { times.push_back(executor.get_time()); });
+
+    REQUIRE(executor.run_many() == 3);
+    // the timer expired while the second handler was running
+    REQUIRE(times == std::vector<steady_time_t>({start, start + milliseconds(5), start + milliseconds(10)}));
+    REQUIRE(executor.get_time() == start + milliseconds(15));
+}
+
+TEST_CASE(SUITE("the cost model is given the tag of each handler"))
+{
+    using std::chrono::milliseconds;
+
+    MockExecutor executor;
+    executor.set_cost_model(HandlerCost::by_tag({ { "read", HandlerCost::fixed(milliseconds(2)) }, { "timeout", HandlerCost::fixed(milliseconds(3)) } }));
+    const auto start = executor.get_time();
+
+    executor.post("read", []() {});
+    executor.post([]() {});
+    executor.start(milliseconds(1), "timeout", []() {});
+
+    REQUIRE(executor.run_many() == 3);
+    REQUIRE(executor.get_time() == start + milliseconds(5));
+}
+
+TEST_CASE(SUITE("run_until interleaves posts and timers in time order"))
+{
+    using std::chrono::milliseconds;
+
+    MockExecutor executor;
+    const auto start = executor.get_time();
+
+    std::vector<std::pair<int, duration_t>> events;
+    auto note = [&](int id) { events.emplace_back(id, executor.get_time() - start); };
+
+    executor.start(milliseconds(30), [&]() { note(3); });
+    executor.start(milliseconds(10), [&]()
+    {
+        note(1);
+        executor.post([&]() { note(2); });
+        executor.start(milliseconds(5), [&]() { note(4); });
+    });
+    executor.post([&]() { note(0); });
+
+    REQUIRE(executor.run_until(start + milliseconds(20)) == 4);
+    REQUIRE(executor.get_time() == start + milliseconds(20));
+    REQUIRE(events == std::vector<std::pair<int, duration_t>>{
+        { 0, milliseconds(0) }, { 1, milliseconds(10) }, { 2, milliseconds(10) }, { 4, milliseconds(15) }
+    });
+    REQUIRE(executor.num_pending_timers() == 1);
+
+    REQUIRE(executor.run_until_idle() == 1);
+    REQUIRE(executor.get_time() == start + milliseconds(30));
+    REQUIRE(events.back() == std::make_pair(3, duration_t(milliseconds(30))));
+    REQUIRE(executor.num_pending_timers() == 0);
+    REQUIRE(executor.run_until_idle() == 0);
+}
+
+TEST_CASE(SUITE("run_until skips canceled timers"))
+{
+    using std::chrono::milliseconds;
+
+    MockExecutor executor;
+    size_t count = 0;
+    auto canceled = executor.start(milliseconds(5), [&]() { ++count; });
+    executor.start(milliseconds(10), [&]() { ++count; });
+
+    REQUIRE(canceled.cancel());
+    REQUIRE_FALSE(canceled.cancel());
+    REQUIRE(executor.num_timer_cancel() == 1);
+    REQUIRE(executor.num_pending_timers() == 1);
+    REQUIRE(executor.next_timer_expiration_rel() == milliseconds(10));
+
+    REQUIRE(executor.run_until_idle() == 1);
+    REQUIRE(count == 1);
+}
+
+TEST_CASE(SUITE("hours of periodic timers run in one call"))
+{
+    using std::chrono::hours;
+    using std::chrono::seconds;
+
+    MockExecutor executor;
+    const auto start = executor.get_time();
+
+    // 10 devices polled every second for 3 hours
+    size_t num_polls = 0;
+    std::vector<action_t> polls(10);
+    for (auto& poll : polls)
+    {
+        poll = [&executor, &num_polls, &poll]()
+        {
+            ++num_polls;
+            executor.start(seconds(1), poll);
+        };
+        executor.start(seconds(1), poll);
+    }
+
+    REQUIRE(executor.run_until(start + hours(3)) == 10 * 3 * 3600);
+    REQUIRE(num_polls == 10 * 3 * 3600);
+    REQUIRE(executor.get_time() == start + hours(3));
+    REQUIRE(executor.num_pending_timers() == 10);
+}
+
+TEST_CASE(SUITE("pending timers are released with the executor"))
+{
+    using std::chrono::milliseconds;
+
+    const auto resource = std::make_shared<int>(0);
+    Timer timer;
+    {
+        MockExecutor executor;
+        timer = executor.start(milliseconds(10), [resource]() {});
+        REQUIRE(resource.use_count() == 2);
+    }
+
+    REQUIRE(resource.use_count() == 1);
+    REQUIRE_FALSE(timer.cancel());
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/MockExecutor.h"
+#include "exe4cpp/OrderedProcessor.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "OrderedProcessor - " name
+
+namespace
+{
+    // executes posted actions in reverse order to simulate workers finishing out of order
+    class ReversingExecutor final : public IExecutor
+    {
+    public:
+        Timer start(const duration_t&, const action_t&) override
+        {
+            return Timer{};
+        }
+
+        Timer start(const steady_time_t&, const action_t&) override
+        {
+            return Timer{};
+        }
+
+        void post(const action_t& action) override
+        {
+            this->actions.push_back(action);
+        }
+
+        steady_time_t get_time() override
+        {
+            return steady_time_t{};
+        }
+
+        size_t run_all()
+        {
+            const auto count = this->actions.size();
+            while (!this->actions.empty())
+            {
+                auto action = this->actions.back();
+                this->actions.pop_back();
+                action();
+            }
+            return count;
+        }
+
+    private:
+        std::vector<action_t> actions;
+    };
+}
+
+TEST_CASE(SUITE("results are delivered in submission order"))
+{
+    const auto workers = std::make_shared<ReversingExecutor>();
+    const auto target = std::make_shared<MockExecutor>();
+
+    std::vector<int> results;
+    const auto processor = OrderedProcessor<int, int>::create(
+        workers,
+        target,
+        16,
+        [](int& value) { return value * 2; },
+        [&](int&& value) { results.push_back(value); }
+    );
+
+    for (int i = 0; i < 10; ++i)
+    {
+        REQUIRE(processor->submit(i));
+    }
+
+    REQUIRE(workers->run_all() == 10);
+    REQUIRE(target->run_many() == 1);
+
+    REQUIRE(results == std::vector<int>({ 0, 2, 4, 6, 8, 10, 12, 14, 16, 18 }));
+    REQUIRE(processor->num_in_flight() == 0);
+}
+
+TEST_CASE(SUITE("submit is rejected when the window is full"))
+{
+    const auto workers = std::make_shared<MockExecutor>();
+    const auto target = std::make_shared<MockExecutor>();
+
+    std::vector<int> results;
+    const auto processor = OrderedProcessor<int, int>::create(
+        workers,
+        target,
+        2,
+        [](int& value) { return value; },
+        [&](int&& value) { results.push_back(value); }
+    );
+
+    REQUIRE(processor->submit(1));
+    REQUIRE(processor->submit(2));
+    REQUIRE_FALSE(processor->submit(3));
+    REQUIRE(processor->num_in_flight() == 2);
+
+    workers->run_many();
+    target->run_many();
+
+    REQUIRE(processor->num_in_flight() == 0);
+    REQUIRE(processor->submit(3));
+    workers->run_many();
+    target->run_many();
+
+    REQUIRE(results == std::vector<int>({ 1, 2, 3 }));
+}
+
+TEST_CASE(SUITE("a throwing transform does not stall the items behind it"))
+{
+    const auto workers = std::make_shared<ReversingExecutor>();
+    const auto target = std::make_shared<MockExecutor>();
+
+    std::vector<int> results;
+    std::vector<std::string> errors;
+    const auto processor = OrderedProcessor<int, int>::create(
+        workers,
+        target,
+        4,
+        [](int& value)
+        {
+            if (value % 3 == 0)
+            {
+                throw std::runtime_error(std::to_string(value));
+            }
+            return value;
+        },
+        [&](int&& value) { results.push_back(value); },
+        [&](std::exception_ptr error)
+        {
+            try
+            {
+                std::rethrow_exception(error);
+            }
+            catch (const std::runtime_error& ex)
+            {
+                errors.push_back(ex.what());
+            }
+        }
+    );
+
+    for (int i = 1; i <= 4; ++i)
+    {
+        REQUIRE(processor->submit(i));
+    }
+    workers->run_all();
+    target->run_many();
+
+    REQUIRE(results == std::vector<int>({ 1, 2, 4 }));
+    REQUIRE(errors == std::vector<std::string>({ "3" }));
+    REQUIRE(processor->num_in_flight() == 0);
+}
+
+TEST_CASE(SUITE("failed items are dropped without an error sink"))
+{
+    const auto workers = std::make_shared<MockExecutor>();
+    const auto target = std::make_shared<MockExecutor>();
+
+    std::vector<int> results;
+    const auto processor = OrderedProcessor<int, int>::create(
+        workers,
+        target,
+        1,
+        [](int& value)
+        {
+            if (value == 1)
+            {
+                throw std::runtime_error("failed");
+            }
+            return value;
+        },
+        [&](int&& value) { results.push_back(value); }
+    );
+
+    REQUIRE(processor->submit(1));
+    workers->run_many();
+    target->run_many();
+
+    // the window is free again
+    REQUIRE(processor->submit(2));
+    workers->run_many();
+    target->run_many();
+
+    REQUIRE(results == std::vector<int>({ 2 }));
+}
+
+TEST_CASE(SUITE("a throwing sink does not stall the results behind it"))
+{
+    const auto workers = std::make_shared<ReversingExecutor>();
+    const auto target = std::make_shared<MockExecutor>();
+
+    std::vector<int> results;
+    const auto processor = OrderedProcessor<int, int>::create(
+        workers,
+        target,
+        4,
+        [](int& value) { return value; },
+        [&](int&& value)
+        {
+            results.push_back(value);
+            if (value == 2)
+            {
+                throw std::runtime_error("sink failed");
+            }
+        }
+    );
+
+    for (int i = 1; i <= 4; ++i)
+    {
+        REQUIRE(processor->submit(i));
+    }
+    workers->run_all();
+
+    REQUIRE_THROWS_AS(target->run_one(), std::runtime_error);
+    REQUIRE(results == std::vector<int>({ 1, 2 }));
+
+    REQUIRE(target->run_many() == 1);
+    REQUIRE(results == std::vector<int>({ 1, 2, 3, 4 }));
+    REQUIRE(processor->num_in_flight() == 0);
+
+    // later completions still schedule a drain
+    REQUIRE(processor->submit(5));
+    workers->run_all();
+    REQUIRE(target->run_many() == 1);
+    REQUIRE(results == std::vector<int>({ 1, 2, 3, 4, 5 }));
+}
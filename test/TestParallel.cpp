@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/MockExecutor.h"
+#include "exe4cpp/Parallel.h"
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "Parallel - " name
+
+TEST_CASE(SUITE("chunks cover the whole range and shrink towards the end"))
+{
+    ChunkedRange range(0, 1000, 4, 10);
+
+    size_t begin = 0;
+    size_t end = 0;
+    size_t expected_begin = 0;
+    size_t previous_size = 1000;
+    while (range.claim(begin, end))
+    {
+        REQUIRE(begin == expected_begin);
+        REQUIRE(end - begin <= previous_size);
+        REQUIRE(end - begin >= std::min<size_t>(10, 1000 - begin));
+        previous_size = end - begin;
+        expected_begin = end;
+    }
+
+    REQUIRE(expected_begin == 1000);
+}
+
+TEST_CASE(SUITE("parallel_for visits every index once and completes on the completion executor"))
+{
+    const auto workers = std::make_shared<MockExecutor>();
+    const auto completion = std::make_shared<MockExecutor>();
+
+    std::vector<int> visits(100, 0);
+    bool complete = false;
+    parallel_for(ParallelWorkers{workers, 4}, 0, visits.size(), [&](size_t i) { ++visits[i]; }, completion, [&]() { complete = true; });
+
+    REQUIRE(workers->run_many() == 4);
+    REQUIRE_FALSE(complete);
+    REQUIRE(completion->run_many() == 1);
+    REQUIRE(complete);
+    REQUIRE(std::all_of(visits.begin(), visits.end(), [](int count) { return count == 1; }));
+}
+
+TEST_CASE(SUITE("parallel_transform writes every output"))
+{
+    const auto executor = std::make_shared<MockExecutor>();
+
+    std::vector<int> input(50);
+    std::iota(input.begin(), input.end(), 0);
+    std::vector<int> output(input.size(), 0);
+
+    bool complete = false;
+    parallel_transform(ParallelWorkers{executor, 3}, input.begin(), input.end(), output.begin(), [](int value) { return value * value; }, executor, [&]() { complete = true; });
+    executor->run_many();
+
+    REQUIRE(complete);
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        REQUIRE(output[i] == input[i] * input[i]);
+    }
+}
+
+TEST_CASE(SUITE("parallel_reduce combines the partial results"))
+{
+    const auto executor = std::make_shared<MockExecutor>();
+
+    uint64_t sum = 0;
+    parallel_reduce<uint64_t>(
+        ParallelWorkers{executor, 8, 16},
+        1,
+        1001,
+        0,
+        [](size_t i) { return static_cast<uint64_t>(i); },
+        [](uint64_t lhs, uint64_t rhs) { return lhs + rhs; },
+        executor,
+        [&](const uint64_t& result) { sum = result; }
+    );
+    executor->run_many();
+
+    REQUIRE(sum == 500500);
+}
+
+TEST_CASE(SUITE("parallel_reduce accepts bool partial results"))
+{
+    const auto executor = std::make_shared<MockExecutor>();
+
+    // each runner has its own partial result, a cache line away from the next one
+    REQUIRE(sizeof(ParallelPartial<bool>) == 64);
+    REQUIRE(sizeof(ParallelPartial<uint64_t>) - sizeof(uint64_t) >= 63);
+
+    bool is_found = false;
+    parallel_reduce<bool>(
+        ParallelWorkers{executor, 4},
+        0,
+        100,
+        false,
+        [](size_t i) { return i == 77; },
+        [](bool lhs, bool rhs) { return lhs || rhs; },
+        executor,
+        [&](const bool& result) { is_found = result; }
+    );
+    executor->run_many();
+
+    REQUIRE(is_found);
+}
+
+TEST_CASE(SUITE("empty range completes immediately"))
+{
+    const auto executor = std::make_shared<MockExecutor>();
+
+    bool complete = false;
+    parallel_for(ParallelWorkers{executor, 4}, 10, 10, [](size_t) {}, executor, [&]() { complete = true; });
+
+    REQUIRE(executor->run_many() == 1);
+    REQUIRE(complete);
+}
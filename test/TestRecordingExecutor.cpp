@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/MockExecutor.h"
+#include "exe4cpp/RecordingExecutor.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace exe4cpp;
+using namespace std::chrono;
+
+#define SUITE(name) "RecordingExecutor - " name
+
+TEST_CASE(SUITE("posts are recorded with their execution"))
+{
+    std::stringstream stream;
+    const auto mock = std::make_shared<MockExecutor>();
+    const auto executor = RecordingExecutor::create(mock, EventRecorder::create(stream));
+
+    int count = 0;
+    auto first = [&count, mock]()
+    {
+        ++count;
+        mock->add_time(milliseconds(2));
+    };
+    auto second = [&count]() { count += 10; };
+    executor->post("first", first);
+    executor->post("second", second);
+    executor->post("first", first);
+    REQUIRE(mock->run_many() == 3);
+    REQUIRE(count == 12);
+
+    const auto log = EventLogReader::read(stream);
+    REQUIRE(log.handlers == std::vector<std::string>{ "first", "second" });
+    REQUIRE(log.events.size() == 9);
+
+    for (uint64_t i = 0; i < 3; ++i)
+    {
+        REQUIRE(log.events[i].kind == EventKind::post);
+        REQUIRE(log.events[i].id == i);
+        REQUIRE(log.events[i].time == duration_t::zero());
+    }
+    REQUIRE(log.events[0].handler == log.events[2].handler);
+    REQUIRE(log.events[0].handler != log.events[1].handler);
+
+    for (uint64_t i = 0; i < 3; ++i)
+    {
+        const auto& run = log.events[3 + 2 * i];
+        const auto& complete = log.events[4 + 2 * i];
+        REQUIRE(run.kind == EventKind::run);
+        REQUIRE(run.id == i);
+        REQUIRE(complete.kind == EventKind::complete);
+        REQUIRE(complete.id == i);
+    }
+
+    REQUIRE(log.durations("first") == std::vector<duration_t>{ milliseconds(2), milliseconds(2) });
+    REQUIRE(log.durations("second") == std::vector<duration_t>{ duration_t::zero() });
+}
+
+TEST_CASE(SUITE("untagged posts and timers share the empty tag"))
+{
+    std::stringstream stream;
+    const auto mock = std::make_shared<MockExecutor>();
+    const auto executor = RecordingExecutor::create(mock, EventRecorder::create(stream));
+
+    executor->post([]() {});
+    executor->post([mock]() { mock->add_time(milliseconds(1)); });
+    executor->start(milliseconds(5), []() {});
+    mock->run_many();
+
+    const auto log = EventLogReader::read(stream);
+    REQUIRE(log.handlers == std::vector<std::string>{ "" });
+    REQUIRE(log.events[0].handler == 0);
+    REQUIRE(log.events[1].handler == 0);
+    REQUIRE(log.events[2].handler == 0);
+}
+
+TEST_CASE(SUITE("timers are recorded with their delay"))
+{
+    std::stringstream stream;
+    const auto mock = std::make_shared<MockExecutor>();
+    const auto executor = RecordingExecutor::create(mock, EventRecorder::create(stream));
+
+    bool is_expired = false;
+    auto timer = executor->start(milliseconds(5), "timeout", [&is_expired]() { is_expired = true; });
+    REQUIRE(timer.expires_at() == mock->get_time() + milliseconds(5));
+
+    mock->advance_time(milliseconds(5));
+    REQUIRE(mock->run_many() == 1);
+    REQUIRE(is_expired);
+    REQUIRE_FALSE(timer.cancel());
+
+    const auto log = EventLogReader::read(stream);
+    REQUIRE(log.events.size() == 3);
+    REQUIRE(log.events[0].kind == EventKind::start);
+    REQUIRE(log.handlers[log.events[0].handler] == "timeout");
+    REQUIRE(log.events[0].delay == milliseconds(5));
+    REQUIRE(log.events[1].kind == EventKind::run);
+    REQUIRE(log.events[1].time == milliseconds(5));
+    REQUIRE(log.events[2].kind == EventKind::complete);
+}
+
+TEST_CASE(SUITE("canceled timers are recorded and do not run"))
+{
+    std::stringstream stream;
+    const auto mock = std::make_shared<MockExecutor>();
+    const auto executor = RecordingExecutor::create(mock, EventRecorder::create(stream));
+
+    bool is_expired = false;
+    auto timer = executor->start(milliseconds(5), [&is_expired]() { is_expired = true; });
+    mock->add_time(milliseconds(1));
+    REQUIRE(timer.cancel());
+    REQUIRE(mock->num_pending_timers() == 0);
+    REQUIRE_FALSE(timer.cancel());
+
+    mock->advance_time(milliseconds(10));
+    REQUIRE(mock->run_many() == 0);
+    REQUIRE_FALSE(is_expired);
+
+    const auto log = EventLogReader::read(stream);
+    REQUIRE(log.events.size() == 2);
+    REQUIRE(log.events[1].kind == EventKind::cancel);
+    REQUIRE(log.events[1].id == log.events[0].id);
+    REQUIRE(log.events[1].time == milliseconds(1));
+}
+
+TEST_CASE(SUITE("a cancel after the timer has expired is not recorded"))
+{
+    std::stringstream stream;
+    const auto mock = std::make_shared<MockExecutor>();
+    const auto executor = RecordingExecutor::create(mock, EventRecorder::create(stream));
+
+    Timer timer;
+    bool is_expired = false;
+    timer = executor->start(milliseconds(5), [&]()
+    {
+        is_expired = true;
+        timer.cancel();
+    });
+
+    mock->advance_time(milliseconds(5));
+    REQUIRE(mock->run_many() == 1);
+    REQUIRE(is_expired);
+
+    const auto log = EventLogReader::read(stream);
+    REQUIRE(log.events.size() == 3);
+    REQUIRE(log.events[2].kind == EventKind::complete);
+}
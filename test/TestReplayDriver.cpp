@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/MockExecutor.h"
+#include "exe4cpp/RecordingExecutor.h"
+#include "exe4cpp/ReplayDriver.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace exe4cpp;
+using namespace std::chrono;
+
+#define SUITE(name) "ReplayDriver - " name
+
+namespace
+{
+    struct Trace
+    {
+        std::vector<std::string> names;
+        std::vector<duration_t> times;
+    };
+
+    // posts, timers and a cancel spread over 30ms of virtual time
+    EventLog record(Trace& trace)
+    {
+        std::stringstream stream;
+        const auto mock = std::make_shared<MockExecutor>();
+        const auto executor = RecordingExecutor::create(mock, EventRecorder::create(stream));
+        const auto origin = mock->get_time();
+
+        auto note = [&trace, mock, origin](const std::string& name)
+        {
+            trace.names.push_back(name);
+            trace.times.push_back(mock->get_time() - origin);
+        };
+
+        executor->post("read", [note]() { note("read"); });
+        executor->start(milliseconds(20), "timeout", [note]() { note("timeout"); });
+        auto canceled = executor->start(milliseconds(15), "retry", [note]() { note("retry"); });
+        mock->run_many();
+
+        mock->advance_time(milliseconds(4));
+        executor->post("read", [note, executor]()
+        {
+            note("read");
+            executor->start(milliseconds(3), "read.timeout", [note]() { note("timeout"); });
+        });
+        mock->run_many();
+
+        mock->advance_to_next_timer();
+        mock->run_many();
+
+        mock->advance_time(milliseconds(3));
+        canceled.cancel();
+        mock->run_many();
+
+        while (mock->advance_to_next_timer())
+        {
+            mock->run_many();
+        }
+
+        return EventLogReader::read(stream);
+    }
+}
+
+TEST_CASE(SUITE("replay reproduces the order and timing of the handlers"))
+{
+    Trace recorded;
+    const auto log = record(recorded);
+    REQUIRE(recorded.names == std::vector<std::string>{ "read", "read", "timeout", "timeout" });
+    REQUIRE(recorded.times == std::vector<duration_t>{ milliseconds(0), milliseconds(4), milliseconds(7), milliseconds(20) });
+
+    MockExecutor executor;
+    executor.add_time(hours(1));
+    const auto origin = executor.get_time();
+
+    std::vector<duration_t> times;
+    ReplayDriver driver{log};
+    driver.on_other_handlers([&](const RecordedEvent& event)
+    {
+        REQUIRE((event.kind == EventKind::post || event.kind == EventKind::start));
+        times.push_back(executor.get_time() - origin);
+    });
+
+    REQUIRE(driver.replay(executor) == 4);
+    REQUIRE(times == recorded.times);
+    REQUIRE(executor.num_pending_timers() == 0);
+}
+
+TEST_CASE(SUITE("handlers are dispatched by tag"))
+{
+    Trace recorded;
+    const auto log = record(recorded);
+
+    std::vector<uint64_t> posts;
+    std::vector<uint64_t> timers;
+    size_t num_other = 0;
+
+    ReplayDriver driver{log};
+    driver.on_other_handlers([&](const RecordedEvent& event)
+    {
+        ++num_other;
+        if (event.kind == EventKind::post)
+        {
+            posts.push_back(event.id);
+        }
+        else
+        {
+            timers.push_back(event.id);
+        }
+    });
+
+    // the timer started by the second read
+    size_t num_nested = 0;
+    driver.on_handler("read.timeout", [&](const RecordedEvent& event)
+    {
+        REQUIRE(event.kind == EventKind::start);
+        REQUIRE(event.delay == milliseconds(3));
+        ++num_nested;
+    });
+
+    MockExecutor executor;
+    REQUIRE(driver.replay(executor) == 4);
+    REQUIRE(num_nested == 1);
+    REQUIRE(num_other == 3);
+    REQUIRE(posts.size() == 2);
+    REQUIRE(timers.size() == 1);
+}
+
+TEST_CASE(SUITE("recorded costs charge each tag its own execution time"))
+{
+    std::stringstream stream;
+    {
+        const auto mock = std::make_shared<MockExecutor>();
+        const auto executor = RecordingExecutor::create(mock, EventRecorder::create(stream));
+        executor->post("slow", [mock]() { mock->add_time(milliseconds(9)); });
+        executor->post("fast", [mock]() { mock->add_time(milliseconds(1)); });
+        executor->start(milliseconds(50), "slow", [mock]() { mock->add_time(milliseconds(9)); });
+        mock->run_until_idle();
+    }
+    const auto log = EventLogReader::read(stream);
+
+    std::vector<duration_t> times;
+    MockExecutor executor;
+    const auto origin = executor.get_time();
+
+    ReplayDriver driver{log};
+    driver.on_other_handlers([&](const RecordedEvent&)
+    {
+        times.push_back(executor.get_time() - origin);
+    });
+    executor.set_cost_model(driver.recorded_costs());
+
+    REQUIRE(driver.replay(executor) == 3);
+    // the timer still expires at its recorded time, after the 10ms taken by the posts
+    REQUIRE(times == std::vector<duration_t>{ milliseconds(0), milliseconds(9), milliseconds(50) });
+    REQUIRE(executor.get_time() - origin == milliseconds(59));
+}
+
+TEST_CASE(SUITE("an empty log replays nothing"))
+{
+    ReplayDriver driver{EventLog{}};
+    MockExecutor executor;
+    const auto start = executor.get_time();
+    REQUIRE(driver.replay(executor) == 0);
+    REQUIRE(executor.get_time() == start);
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/RingQueue.h"
+
+#include <memory>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "RingQueue - " name
+
+TEST_CASE(SUITE("elements are popped in push order across wrap-around and growth"))
+{
+    RingQueue<int> queue(4);
+
+    int next_push = 0;
+    int next_pop = 0;
+    for (int round = 0; round < 10; ++round)
+    {
+        // the queue moves forward, wraps around and grows every other round
+        for (int i = 0; i < 3 + round; ++i)
+        {
+            queue.push_back(next_push++);
+        }
+        while (queue.size() > static_cast<size_t>(round))
+        {
+            REQUIRE(queue.front() == next_pop++);
+            queue.pop_front();
+        }
+    }
+
+    while (!queue.empty())
+    {
+        REQUIRE(queue.front() == next_pop++);
+        queue.pop_front();
+    }
+    REQUIRE(next_pop == next_push);
+}
+
+TEST_CASE(SUITE("capacity is kept when the queue is drained"))
+{
+    RingQueue<int> queue(2);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        queue.push_back(i);
+    }
+    REQUIRE(queue.capacity() == 8);
+
+    while (!queue.empty())
+    {
+        queue.pop_front();
+    }
+    REQUIRE(queue.capacity() == 8);
+}
+
+TEST_CASE(SUITE("popped elements are released"))
+{
+    RingQueue<std::shared_ptr<int>> queue;
+
+    const auto value = std::make_shared<int>(42);
+    queue.push_back(value);
+    REQUIRE(value.use_count() == 2);
+
+    queue.pop_front();
+    REQUIRE(value.use_count() == 1);
+}
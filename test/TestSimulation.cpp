@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/Simulation.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace exe4cpp;
+using namespace std::chrono;
+
+#define SUITE(name) "Simulation - " name
+
+TEST_CASE(SUITE("actions run in global post order"))
+{
+    Simulation sim;
+    const auto a = sim.create_executor();
+    const auto b = sim.create_executor();
+
+    std::vector<int> order;
+    a->post([&]() { order.push_back(1); b->post([&]() { order.push_back(4); }); });
+    b->post([&]() { order.push_back(2); });
+    a->post([&]() { order.push_back(3); });
+
+    REQUIRE(sim.run_many() == 4);
+    REQUIRE(order == std::vector<int>({1, 2, 3, 4}));
+}
+
+TEST_CASE(SUITE("clock jumps to the next timer across executors"))
+{
+    Simulation sim;
+    const auto a = sim.create_executor();
+    const auto b = sim.create_executor();
+    const auto start = sim.get_time();
+
+    std::vector<std::pair<int, steady_time_t>> fired;
+    a->start(seconds(30), [&]() { fired.emplace_back(30, a->get_time()); });
+    b->start(seconds(10), [&]() { fired.emplace_back(10, b->get_time()); });
+    b->start(seconds(20), [&]() { fired.emplace_back(20, b->get_time()); });
+    a->start(seconds(10), [&]() { fired.emplace_back(11, a->get_time()); });
+
+    REQUIRE(sim.num_pending_timers() == 4);
+    REQUIRE(sim.run_until(start + seconds(25)) == 3);
+    REQUIRE(sim.get_time() == start + seconds(25));
+    REQUIRE(fired.size() == 3);
+    REQUIRE(fired[0] == std::make_pair(10, start + seconds(10)));
+    REQUIRE(fired[1] == std::make_pair(11, start + seconds(10)));
+    REQUIRE(fired[2] == std::make_pair(20, start + seconds(20)));
+
+    REQUIRE(sim.run_until_idle() == 1);
+    REQUIRE(sim.get_time() == start + seconds(30));
+    REQUIRE(fired[3] == std::make_pair(30, start + seconds(30)));
+    REQUIRE(sim.num_pending_timers() == 0);
+}
+
+TEST_CASE(SUITE("canceled timers never run"))
+{
+    Simulation sim;
+    const auto executor = sim.create_executor();
+
+    bool is_run = false;
+    auto timer = executor->start(seconds(1), [&]() { is_run = true; });
+    executor->start(seconds(2), [&]() { timer.cancel(); });
+
+    REQUIRE(timer.cancel());
+    REQUIRE(sim.num_pending_timers() == 1);
+    REQUIRE(sim.run_until_idle() == 1);
+    REQUIRE_FALSE(is_run);
+    REQUIRE(executor->num_timer_cancel() == 1);
+}
+
+TEST_CASE(SUITE("many devices with periodic timers"))
+{
+    const int NUM_DEVICES = 10000;
+
+    Simulation sim;
+    std::vector<std::shared_ptr<MockExecutor>> devices;
+    size_t num_polls = 0;
+
+    std::function<void(MockExecutor&, duration_t)> poll = [&](MockExecutor& device, duration_t period)
+    {
+        ++num_polls;
+        device.start(period, [&, period]() { poll(device, period); });
+    };
+
+    for (int i = 0; i < NUM_DEVICES; ++i)
+    {
+        const auto device = sim.create_executor();
+        devices.push_back(device);
+        // spread the devices over a few periods
+        const auto period = seconds(10 + i % 5);
+        device->post([&, device, period]() { poll(*device, period); });
+    }
+
+    sim.run_for(minutes(1));
+
+    // each device polls at time zero, then every period
+    size_t expected = 0;
+    for (int i = 0; i < NUM_DEVICES; ++i)
+    {
+        expected += 1 + 60 / (10 + i % 5);
+    }
+    REQUIRE(num_polls == expected);
+    REQUIRE(sim.num_pending_timers() == NUM_DEVICES);
+}
+
+TEST_CASE(SUITE("runs are deterministic"))
+{
+    auto run = []()
+    {
+        Simulation sim;
+        std::string trace;
+        std::vector<std::shared_ptr<MockExecutor>> executors;
+        for (int i = 0; i < 4; ++i)
+        {
+            executors.push_back(sim.create_executor());
+        }
+
+        for (int i = 0; i < 20; ++i)
+        {
+            const auto& executor = executors[i % 4];
+            executor->start(milliseconds((i * 7) % 5), [&, executor, i]()
+            {
+                trace += std::to_string(i) + ",";
+                executors[(i + 1) % 4]->post([&trace, i]() { trace += "p" + std::to_string(i) + ","; });
+            });
+        }
+
+        sim.run_until_idle();
+        return trace;
+    };
+
+    const auto first = run();
+    REQUIRE(first.size() > 0);
+    REQUIRE(run() == first);
+}
+
+TEST_CASE(SUITE("handlers of an executor with a cost run one at a time"))
+{
+    Simulation sim;
+    sim.set_cost_model(HandlerCost::fixed(milliseconds(10)));
+    const auto executor = sim.create_executor();
+    const auto start = sim.get_time();
+
+    std::vector<steady_time_t> times;
+    for (int i = 0; i < 3; ++i)
+    {
+        executor->post([&]() { times.push_back(executor->get_time()); });
+    }
+
+    REQUIRE(sim.run_until_idle() == 3);
+    REQUIRE(times == std::vector<steady_time_t>({start, start + milliseconds(10), start + milliseconds(20)}));
+    REQUIRE(sim.get_time() == start + milliseconds(30));
+
+    const auto stats = sim.get_stats();
+    REQUIRE(stats.num_handlers == 3);
+    REQUIRE(stats.busy_time == milliseconds(30));
+    REQUIRE(stats.total_wait == milliseconds(30));
+    REQUIRE(stats.max_wait == milliseconds(20));
+}
+
+TEST_CASE(SUITE("executors contend for a limited number of workers"))
+{
+    const int NUM_EXECUTORS = 8;
+
+    for (size_t num_workers : {1u, 2u, 4u, 8u})
+    {
+        Simulation sim;
+        sim.set_cost_model(HandlerCost::fixed(milliseconds(10)));
+        sim.set_num_workers(num_workers);
+        const auto start = sim.get_time();
+
+        for (int i = 0; i < NUM_EXECUTORS; ++i)
+        {
+            const auto executor = sim.create_executor();
+            executor->post([]() {});
+            executor->post([]() {});
+        }
+
+        REQUIRE(sim.run_until_idle() == 2 * NUM_EXECUTORS);
+        const auto elapsed = sim.get_time() - start;
+        REQUIRE(elapsed == milliseconds(10) * (2 * NUM_EXECUTORS / num_workers));
+        REQUIRE(sim.get_stats().utilization(elapsed, num_workers) == Approx(1.0));
+    }
+}
+
+TEST_CASE(SUITE("an executor can override the cost model of the simulation"))
+{
+    Simulation sim;
+    sim.set_cost_model(HandlerCost::fixed(milliseconds(1)));
+    const auto fast = sim.create_executor();
+    const auto slow = sim.create_executor();
+    slow->set_cost_model(HandlerCost::fixed(milliseconds(100)));
+
+    fast->post([]() {});
+    slow->post([]() {});
+
+    REQUIRE(sim.run_until_idle() == 2);
+    REQUIRE(sim.get_stats().busy_time == milliseconds(101));
+}
+
+TEST_CASE(SUITE("queueing latency grows as the load approaches saturation"))
+{
+    // M/D/1-like scenario: requests arrive every 10ms on average, on many sessions sharing a worker
+    auto mean_wait = [](duration_t cost)
+    {
+        Simulation sim;
+        sim.set_num_workers(1);
+        sim.set_cost_model(HandlerCost::fixed(cost));
+
+        std::vector<std::shared_ptr<MockExecutor>> sessions;
+        for (int i = 0; i < 16; ++i)
+        {
+            sessions.push_back(sim.create_executor());
+        }
+
+        auto arrivals = HandlerCost::sampled(std::exponential_distribution<double>{1.0}, milliseconds(10), 42);
+        auto time = sim.get_time();
+        for (int i = 0; i < 2000; ++i)
+        {
+            time += arrivals("");
+            const auto& session = sessions[i % sessions.size()];
+            session->start(time, [session]() { session->post([]() {}); });
+        }
+
+        sim.run_until_idle();
+        return sim.get_stats().mean_wait();
+    };
+
+    const auto light = mean_wait(milliseconds(2));
+    const auto heavy = mean_wait(milliseconds(9));
+
+    REQUIRE(light < milliseconds(2));
+    REQUIRE(heavy > light * 5);
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/MockExecutor.h"
+#include "exe4cpp/TaskGraph.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "TaskGraph - " name
+
+TEST_CASE(SUITE("tasks run after their predecessors"))
+{
+    const auto executor = std::make_shared<MockExecutor>();
+    const auto graph = TaskGraph::create();
+
+    std::vector<int> order;
+    const auto a = graph->add_task([&]() { order.push_back(0); });
+    const auto b = graph->add_task([&]() { order.push_back(1); });
+    const auto c = graph->add_task([&]() { order.push_back(2); });
+    const auto d = graph->add_task([&]() { order.push_back(3); });
+    graph->precede(a, b);
+    graph->precede(a, c);
+    graph->precede(b, d);
+    graph->precede(c, d);
+
+    bool complete = false;
+    REQUIRE(graph->run(executor, executor, [&]() { complete = true; }));
+    REQUIRE(graph->is_running());
+    REQUIRE_FALSE(graph->run(executor, executor, []() {}));
+
+    executor->run_many();
+
+    REQUIRE(complete);
+    REQUIRE_FALSE(graph->is_running());
+    REQUIRE(order == std::vector<int>({ 0, 1, 2, 3 }));
+}
+
+TEST_CASE(SUITE("graph can be executed many times"))
+{
+    const auto executor = std::make_shared<MockExecutor>();
+    const auto graph = TaskGraph::create();
+
+    int count = 0;
+    const auto a = graph->add_task([&]() { ++count; });
+    const auto b = graph->add_task([&]() { ++count; });
+    graph->precede(a, b);
+
+    int num_complete = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        REQUIRE(graph->run(executor, executor, [&]() { ++num_complete; }));
+        executor->run_many();
+    }
+
+    REQUIRE(count == 6);
+    REQUIRE(num_complete == 3);
+}
+
+TEST_CASE(SUITE("graph with a cycle is rejected"))
+{
+    const auto executor = std::make_shared<MockExecutor>();
+    const auto graph = TaskGraph::create();
+
+    const auto a = graph->add_task([]() {});
+    const auto b = graph->add_task([]() {});
+    graph->precede(a, b);
+    graph->precede(b, a);
+
+    REQUIRE_FALSE(graph->run(executor, executor, []() {}));
+    REQUIRE_FALSE(graph->is_running());
+}
+
+TEST_CASE(SUITE("a throwing task aborts the run"))
+{
+    const auto executor = std::make_shared<MockExecutor>();
+    const auto graph = TaskGraph::create();
+
+    bool should_throw = true;
+    std::vector<int> order;
+    const auto a = graph->add_task([&]() { order.push_back(0); });
+    const auto b = graph->add_task([&]()
+    {
+        order.push_back(1);
+        if (should_throw)
+        {
+            throw std::runtime_error("task failed");
+        }
+    });
+    const auto c = graph->add_task([&]() { order.push_back(2); });
+    graph->precede(a, b);
+    graph->precede(b, c);
+
+    std::string message;
+    bool complete = false;
+    auto on_complete = [&](std::exception_ptr error)
+    {
+        complete = true;
+        message.clear();
+        if (error)
+        {
+            try
+            {
+                std::rethrow_exception(error);
+            }
+            catch (const std::runtime_error& ex)
+            {
+                message = ex.what();
+            }
+        }
+    };
+
+    REQUIRE(graph->run(executor, executor, on_complete));
+    executor->run_many();
+
+    REQUIRE(complete);
+    REQUIRE(message == "task failed");
+    REQUIRE_FALSE(graph->is_running());
+    REQUIRE(order == std::vector<int>({ 0, 1 }));
+
+    // the next run starts afresh
+    should_throw = false;
+    complete = false;
+    order.clear();
+    REQUIRE(graph->run(executor, executor, on_complete));
+    executor->run_many();
+
+    REQUIRE(complete);
+    REQUIRE(message.empty());
+    REQUIRE(order == std::vector<int>({ 0, 1, 2 }));
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/TimerHeap.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "TimerHeap - " name
+
+namespace
+{
+    struct node_t : TimerHeapNode
+    {
+        int id = 0;
+    };
+
+    steady_time_t at(int ms)
+    {
+        return steady_time_t(std::chrono::milliseconds(ms));
+    }
+}
+
+TEST_CASE(SUITE("pops in expiration order, then in insertion order"))
+{
+    std::vector<node_t> nodes(6);
+    const int expirations[] = { 3, 1, 2, 1, 3, 0 };
+
+    TimerHeap<node_t> heap;
+    for (int i = 0; i < 6; ++i)
+    {
+        nodes[i].id = i;
+        nodes[i].expiration = at(expirations[i]);
+        heap.push(&nodes[i]);
+    }
+
+    std::vector<int> order;
+    while (!heap.empty())
+    {
+        order.push_back(heap.pop()->id);
+    }
+
+    REQUIRE(order == std::vector<int>({ 5, 1, 3, 2, 0, 4 }));
+}
+
+TEST_CASE(SUITE("removes nodes from anywhere in the heap"))
+{
+    const int NUM_NODES = 200;
+
+    std::vector<node_t> nodes(NUM_NODES);
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> distribution(0, 50);
+
+    TimerHeap<node_t> heap;
+    for (int i = 0; i < NUM_NODES; ++i)
+    {
+        nodes[i].id = i;
+        nodes[i].expiration = at(distribution(random));
+        heap.push(&nodes[i]);
+    }
+
+    for (int i = 0; i < NUM_NODES; i += 3)
+    {
+        heap.remove(&nodes[i]);
+        REQUIRE_FALSE(nodes[i].is_in_heap());
+    }
+
+    // removing twice does nothing
+    heap.remove(&nodes[0]);
+
+    std::vector<node_t*> expected;
+    for (int i = 0; i < NUM_NODES; ++i)
+    {
+        if (i % 3 != 0)
+        {
+            expected.push_back(&nodes[i]);
+        }
+    }
+    std::stable_sort(expected.begin(), expected.end(), [](const node_t* lhs, const node_t* rhs)
+    {
+        return lhs->expiration < rhs->expiration;
+    });
+
+    REQUIRE(heap.size() == expected.size());
+    for (const auto node : expected)
+    {
+        REQUIRE(heap.pop() == node);
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/TimerSlack.h"
+
+using namespace exe4cpp;
+
+#define SUITE(name) "TimerSlack - " name
+
+TEST_CASE(SUITE("granularity is the largest power of two not greater than the slack"))
+{
+    REQUIRE(TimerSlack::granularity(duration_t::zero()) == duration_t::zero());
+    REQUIRE(TimerSlack::granularity(duration_t(-5)) == duration_t::zero());
+    REQUIRE(TimerSlack::granularity(duration_t(1)) == duration_t(1));
+    REQUIRE(TimerSlack::granularity(duration_t(1000)) == duration_t(512));
+    REQUIRE(TimerSlack::granularity(duration_t(1024)) == duration_t(1024));
+}
+
+TEST_CASE(SUITE("aligned expiration stays within the slack window"))
+{
+    const auto slack = std::chrono::milliseconds(10);
+
+    for (auto ns = 0; ns < 50000000; ns += 999983)
+    {
+        const steady_time_t expiration{std::chrono::nanoseconds(ns)};
+        const auto aligned = TimerSlack::align(expiration, slack);
+
+        REQUIRE(aligned >= expiration);
+        REQUIRE(aligned <= expiration + slack);
+        REQUIRE(aligned.time_since_epoch().count() % TimerSlack::granularity(slack).count() == 0);
+    }
+}
+
+TEST_CASE(SUITE("zero slack leaves the expiration untouched"))
+{
+    const steady_time_t expiration{std::chrono::nanoseconds(123456789)};
+    REQUIRE(TimerSlack::align(expiration, duration_t::zero()) == expiration);
+}
+
+TEST_CASE(SUITE("overlapping windows share an aligned expiration"))
+{
+    const auto slack = std::chrono::milliseconds(4);
+    const steady_time_t base{TimerSlack::granularity(slack) * 24};
+
+    REQUIRE(TimerSlack::align(base + std::chrono::microseconds(100), slack) == TimerSlack::align(base + std::chrono::microseconds(900), slack));
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/TscTimeSource.h"
+
+#include <thread>
+#include <vector>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "TscTimeSource - " name
+
+namespace
+{
+    duration_t distance(steady_time_t lhs, steady_time_t rhs)
+    {
+        return lhs < rhs ? rhs - lhs : lhs - rhs;
+    }
+}
+
+TEST_CASE(SUITE("stays close to steady_clock"))
+{
+    TscTimeSource source{std::chrono::milliseconds(10)};
+
+    for (int i = 0; i < 5; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(11));
+        REQUIRE(distance(source.get_time(), std::chrono::steady_clock::now()) < std::chrono::milliseconds(1));
+    }
+}
+
+TEST_CASE(SUITE("is monotonic across recalibrations"))
+{
+    TscTimeSource source{std::chrono::microseconds(100)};
+
+    auto last = source.get_time();
+    for (int i = 0; i < 100000; ++i)
+    {
+        if (i % 1000 == 0)
+        {
+            source.recalibrate();
+        }
+
+        const auto time = source.get_time();
+        REQUIRE(last <= time);
+        last = time;
+    }
+}
+
+TEST_CASE(SUITE("is monotonic when read from several threads during recalibrations"))
+{
+    TscTimeSource source{std::chrono::microseconds(50)};
+
+    std::vector<char> is_monotonic(4, 1);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < is_monotonic.size(); ++t)
+    {
+        threads.emplace_back([&source, &is_monotonic, t]()
+        {
+            auto last = source.get_time();
+            for (int i = 0; i < 100000; ++i)
+            {
+                const auto time = source.get_time();
+                if (time < last)
+                {
+                    is_monotonic[t] = 0;
+                }
+                last = time;
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(is_monotonic == std::vector<char>(4, 1));
+}
+
+#if !defined(__x86_64__)
+TEST_CASE(SUITE("falls back to steady_clock"))
+{
+    TscTimeSource source;
+
+    REQUIRE_FALSE(source.is_tsc());
+}
+#endif
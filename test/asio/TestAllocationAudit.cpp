@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "AllocationAudit.h"
+
+#include "exe4cpp/DeadlineExecutor.h"
+#include "exe4cpp/asio/BasicExecutor.h"
+#include "exe4cpp/asio/KeyedExecutor.h"
+#include "exe4cpp/asio/PriorityStrandExecutor.h"
+#include "exe4cpp/asio/StrandExecutor.h"
+
+using namespace exe4cpp;
+
+#define SUITE(name) "AllocationAuditTestSuite - " name
+
+namespace
+{
+    const size_t NUM_OPS = 100;
+
+    template <typename operation_t>
+    size_t audit(asio::io_service& io_service, const operation_t& operation)
+    {
+        return count_steady_state_allocations(io_service, NUM_OPS, operation);
+    }
+
+    struct fixture_t
+    {
+        const std::shared_ptr<asio::io_service> io_service = std::make_shared<asio::io_service>();
+        int count = 0;
+
+        // fits in the small buffer of std::function, copying it never allocates
+        const action_t light = [this]() { ++count; };
+
+        // captures a shared_ptr, so every copy of the std::function allocates. Auditing with it
+        // checks that an executor copies the action exactly once per operation.
+        const action_t heavy = [this, token = std::make_shared<int>(0)]() { ++count; };
+    };
+
+    template <typename executor_t>
+    void audit_executor(fixture_t& f, executor_t& executor)
+    {
+        REQUIRE(audit(*f.io_service, [&]() { executor.post(f.light); }) == 0);
+        REQUIRE(audit(*f.io_service, [&]() { executor.start(duration_t::zero(), f.light); }) == 0);
+        REQUIRE(audit(*f.io_service, [&]() { executor.start(std::chrono::hours(1), f.light).cancel(); }) == 0);
+
+        REQUIRE(audit(*f.io_service, [&]() { executor.post(f.heavy); }) == NUM_OPS);
+        REQUIRE(audit(*f.io_service, [&]() { executor.start(duration_t::zero(), f.heavy); }) == NUM_OPS);
+    }
+}
+
+TEST_CASE(SUITE("BasicExecutor"))
+{
+    fixture_t f;
+    const auto executor = BasicExecutor::create(f.io_service);
+
+    audit_executor(f, *executor);
+}
+
+TEST_CASE(SUITE("StrandExecutor"))
+{
+    fixture_t f;
+    const auto executor = StrandExecutor::create(f.io_service);
+    const auto other = executor->fork();
+    const action_t hop = [&]() { other->post(f.light); };
+
+    audit_executor(f, *executor);
+    REQUIRE(audit(*f.io_service, [&]() { executor->post(hop); }) == 0);
+}
+
+TEST_CASE(SUITE("StrandExecutor with a budget"))
+{
+    fixture_t f;
+    StrandBudget budget;
+    budget.max_handlers = 10;
+    const auto executor = StrandExecutor::create(f.io_service, budget);
+    const auto other = executor->fork();
+    const action_t hop = [&]() { other->post(f.light); };
+
+    audit_executor(f, *executor);
+    REQUIRE(audit(*f.io_service, [&]() { executor->post(hop); }) == 0);
+}
+
+TEST_CASE(SUITE("KeyedExecutor"))
+{
+    fixture_t f;
+    const auto executor = KeyedExecutor<int>::create(f.io_service, 4);
+
+    int key = 0;
+    REQUIRE(audit(*f.io_service, [&]() { executor->post(++key, f.light); }) == 0);
+    REQUIRE(audit(*f.io_service, [&]() { executor->start(++key, duration_t::zero(), f.light); }) == 0);
+}
+
+TEST_CASE(SUITE("PriorityStrandExecutor"))
+{
+    fixture_t f;
+    const auto executor = PriorityStrandExecutor::create(f.io_service, { 4, 1 });
+
+    audit_executor(f, *executor);
+    REQUIRE(audit(*f.io_service, [&]() { executor->post(0, f.light); executor->post(1, f.light); }) == 0);
+}
+
+TEST_CASE(SUITE("DeadlineExecutor"))
+{
+    fixture_t f;
+    const auto executor = DeadlineExecutor::create(StrandExecutor::create(f.io_service), std::chrono::seconds(1));
+
+    // each drain captures a shared_ptr and is copied once more by the strand, a drain runs up to 32 events
+    const size_t drain_allocations = 2 * ((NUM_OPS + 31) / 32);
+
+    REQUIRE(audit(*f.io_service, [&]() { executor->post(f.light); }) == drain_allocations);
+
+    // the decorator wraps the action of a timer in a new action_t, which is too large for the small
+    // buffer of std::function and is copied once more by the underlying executor
+    REQUIRE(audit(*f.io_service, [&]() { executor->start(duration_t::zero(), f.light); }) == 2 * NUM_OPS + drain_allocations);
+    REQUIRE(audit(*f.io_service, [&]() { executor->start(std::chrono::hours(1), f.light).cancel(); }) == 2 * NUM_OPS);
+}
@@ -26,6 +26,12 @@
 
 #include <exe4cpp/asio/BasicExecutor.h>
 
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
 using namespace exe4cpp;
 
 #define SUITE(name) "BasicExecutorTestSuite - " name
@@ -35,3 +41,103 @@ TEST_CASE(SUITE("can be created"))
     const auto executor = BasicExecutor::create(std::make_shared<asio::io_service>());
 }
 
+
+TEST_CASE(SUITE("handlers share a cached timestamp"))
+{
+    const auto io_service = std::make_shared<asio::io_service>();
+    const auto cache = CachedTimeSource::create();
+    const auto executor = BasicExecutor::create(io_service, cache);
+
+    std::vector<steady_time_t> times;
+    const action_t record = [&]()
+    {
+        times.push_back(executor->get_time());
+        times.push_back(executor->get_time());
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    };
+
+    executor->post(record);
+    executor->post(record);
+    executor->start(duration_t::zero(), record);
+    io_service->run();
+
+    REQUIRE(times.size() == 6);
+    for (size_t i = 0; i < times.size(); i += 2)
+    {
+        // the same timestamp within a handler, a new one for every handler
+        REQUIRE(times[i] == times[i + 1]);
+        if (i > 0)
+        {
+            REQUIRE(times[i - 1] < times[i]);
+        }
+    }
+}
+
+TEST_CASE(SUITE("timers with overlapping slack windows expire together"))
+{
+    const auto io_service = std::make_shared<asio::io_service>();
+    const auto executor = BasicExecutor::create(io_service);
+
+    std::vector<int> order;
+    // started at slightly different times, the alignment puts them on the same instant
+    auto t1 = executor->start(std::chrono::milliseconds(2), [&]() { order.push_back(1); }, std::chrono::milliseconds(20));
+    auto t2 = executor->start(std::chrono::milliseconds(2), [&]() { order.push_back(2); }, std::chrono::milliseconds(20));
+    auto t3 = executor->start(std::chrono::milliseconds(2), [&]() { order.push_back(3); }, std::chrono::milliseconds(20));
+
+    REQUIRE(executor->num_pending_timers() == 3);
+    REQUIRE(t1.expires_at() == t2.expires_at());
+    REQUIRE(t1.expires_at() == t3.expires_at());
+
+    t2.cancel();
+    REQUIRE(executor->num_pending_timers() == 2);
+
+    io_service->run();
+
+    REQUIRE(order == std::vector<int>({1, 3}));
+    REQUIRE(executor->num_pending_timers() == 0);
+}
+
+TEST_CASE(SUITE("canceling every timer disarms the underlying timer"))
+{
+    const auto io_service = std::make_shared<asio::io_service>();
+    const auto executor = BasicExecutor::create(io_service);
+
+    bool is_run = false;
+    auto t1 = executor->start(std::chrono::seconds(5), [&]() { is_run = true; }, std::chrono::seconds(1));
+    auto t2 = executor->start(std::chrono::seconds(5), [&]() { is_run = true; }, std::chrono::seconds(1));
+
+    t1.cancel();
+    t2.cancel();
+    REQUIRE(executor->num_pending_timers() == 0);
+
+    const auto start = std::chrono::steady_clock::now();
+    io_service->run();
+
+    REQUIRE_FALSE(is_run);
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+}
+
+TEST_CASE(SUITE("timers that expire together run from one completion in deadline order"))
+{
+    const auto io_service = std::make_shared<asio::io_service>();
+    const auto executor = BasicExecutor::create(io_service);
+
+    std::vector<int> delays(1000);
+    std::iota(delays.begin(), delays.end(), 0);
+    std::shuffle(delays.begin(), delays.end(), std::mt19937{});
+
+    const auto now = executor->get_time();
+    std::vector<int> order;
+    for (auto i : delays)
+    {
+        executor->start(now + std::chrono::microseconds(i), [&order, i]() { order.push_back(i); });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    const auto num_handlers = io_service->run();
+
+    REQUIRE(order.size() == 1000);
+    REQUIRE(std::is_sorted(order.begin(), order.end()));
+    // the batch, and the waits aborted each time an earlier timer re-armed the underlying timer
+    REQUIRE(num_handlers < 30);
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "AllocationAudit.h"
+
+#include "exe4cpp/asio/BasicExecutor.h"
+#include "exe4cpp/asio/StrandExecutor.h"
+#include "exe4cpp/asio/ThreadPool.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "HandlerMemoryTestSuite - " name
+
+namespace
+{
+    const int NUM_OPS = 100;
+
+    // post from this thread to a pool thread, counting the allocations of both threads in the third round
+    size_t count_cross_thread_allocations(IExecutor& executor, std::atomic<int>& count)
+    {
+        const action_t increment = [&count]() { ++count; };
+
+        size_t allocations = 0;
+        for (int round = 0; round < 3; ++round)
+        {
+            GlobalAllocationCounter counter;
+            for (int i = 0; i < NUM_OPS; ++i)
+            {
+                executor.post(increment);
+            }
+            while (count < (round + 1) * NUM_OPS)
+            {
+                std::this_thread::yield();
+            }
+            allocations = counter.count();
+        }
+        return allocations;
+    }
+}
+
+TEST_CASE(SUITE("blocks are recycled by the thread cache"))
+{
+    auto first = HandlerMemory::allocate(100);
+    HandlerMemory::deallocate(first, 100);
+
+    AllocationCounter counter;
+    auto second = HandlerMemory::allocate(120);
+    HandlerMemory::deallocate(second, 120);
+
+    REQUIRE(second == first);
+    REQUIRE(counter.count() == 0);
+}
+
+TEST_CASE(SUITE("blocks freed by another thread go back to the allocating thread"))
+{
+    // more than the thread cache holds, so the last allocations empty it
+    const size_t num_blocks = 300;
+
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < num_blocks; ++i)
+    {
+        blocks.push_back(HandlerMemory::allocate(100));
+    }
+
+    std::thread{[&blocks]()
+    {
+        for (auto block : blocks)
+        {
+            HandlerMemory::deallocate(block, 100);
+        }
+    }}.join();
+
+    AllocationCounter counter;
+    for (auto& block : blocks)
+    {
+        block = HandlerMemory::allocate(100);
+    }
+    REQUIRE(counter.count() == 0);
+
+    for (auto block : blocks)
+    {
+        HandlerMemory::deallocate(block, 100);
+    }
+}
+
+TEST_CASE(SUITE("BasicExecutor post and timer do not allocate in steady state"))
+{
+    const auto io_service = std::make_shared<asio::io_service>();
+    const auto executor = BasicExecutor::create(io_service);
+
+    int count = 0;
+    const action_t increment = [&count]() { ++count; };
+
+    REQUIRE(count_steady_state_allocations(*io_service, NUM_OPS, [&]() { executor->post(increment); }) == 0);
+    REQUIRE(count_steady_state_allocations(*io_service, NUM_OPS, [&]() { executor->start(duration_t::zero(), increment); }) == 0);
+    REQUIRE(count == 8 * NUM_OPS);
+}
+
+TEST_CASE(SUITE("StrandExecutor post and timer do not allocate in steady state"))
+{
+    const auto io_service = std::make_shared<asio::io_service>();
+    const auto executor = StrandExecutor::create(io_service);
+
+    int count = 0;
+    const action_t increment = [&count]() { ++count; };
+
+    REQUIRE(count_steady_state_allocations(*io_service, NUM_OPS, [&]() { executor->post(increment); }) == 0);
+    REQUIRE(count_steady_state_allocations(*io_service, NUM_OPS, [&]() { executor->start(duration_t::zero(), increment); }) == 0);
+    REQUIRE(count == 8 * NUM_OPS);
+}
+
+TEST_CASE(SUITE("posts run by another thread do not allocate in steady state"))
+{
+    const auto io_service = std::make_shared<asio::io_service>();
+    ThreadPool pool{io_service, 1};
+
+    std::atomic<int> basic_count{0};
+    REQUIRE(count_cross_thread_allocations(*BasicExecutor::create(io_service), basic_count) == 0);
+
+    std::atomic<int> strand_count{0};
+    REQUIRE(count_cross_thread_allocations(*StrandExecutor::create(io_service), strand_count) == 0);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/asio/ThreadPool.h"
+#include "exe4cpp/asio/KeyedExecutor.h"
+
+#include <set>
+
+using namespace std;
+using namespace exe4cpp;
+
+#define SUITE(name) "KeyedExecutorTestSuite - " name
+
+TEST_CASE(SUITE("keys are mapped onto a bounded number of strands"))
+{
+    const size_t NUM_STRAND = 8;
+    const uint32_t NUM_KEY = 10000;
+
+    const auto executor = KeyedExecutor<uint32_t>::create(std::make_shared<asio::io_service>(), NUM_STRAND);
+
+    REQUIRE(executor->num_strands() == NUM_STRAND);
+
+    std::set<StrandExecutor*> strands;
+    for (uint32_t key = 0; key < NUM_KEY; ++key)
+    {
+        REQUIRE(executor->get_executor(key) == executor->get_executor(key));
+        strands.insert(executor->get_executor(key).get());
+    }
+
+    REQUIRE(strands.size() == NUM_STRAND);
+}
+
+TEST_CASE(SUITE("dispatch is in post order for each key"))
+{
+    const int NUM_THREAD = 10;
+    const size_t NUM_STRAND = 4;
+    const int NUM_KEY = 100;
+    const int NUM_OPS = 100;
+
+    const auto io_service = std::make_shared<asio::io_service>();
+
+    int order[NUM_KEY] = { 0 };
+    bool is_ordered[NUM_KEY];
+    std::fill(std::begin(is_ordered), std::end(is_ordered), true);
+
+    {
+        ThreadPool pool(io_service, NUM_THREAD);
+        const auto executor = KeyedExecutor<int>::create(io_service, NUM_STRAND);
+
+        for (int i = 0; i < NUM_OPS; ++i)
+        {
+            for (int key = 0; key < NUM_KEY; ++key)
+            {
+                auto test_order = [i, &order = order[key], &is_ordered = is_ordered[key]]()
+                {
+                    if (i == order)
+                    {
+                        ++order;
+                    }
+                    else
+                    {
+                        is_ordered = false;
+                    }
+                };
+                executor->post(key, test_order);
+            }
+        }
+    } // pool stops when it goes out of scope
+
+    for (int key = 0; key < NUM_KEY; ++key)
+    {
+        REQUIRE(is_ordered[key]);
+        REQUIRE(order[key] == NUM_OPS);
+    }
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/asio/ThreadPool.h"
+#include "exe4cpp/asio/PriorityStrandExecutor.h"
+
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace exe4cpp;
+
+#define SUITE(name) "PriorityStrandExecutorTestSuite - " name
+
+TEST_CASE(SUITE("lanes are served by weighted round-robin"))
+{
+    const auto io_service = std::make_shared<asio::io_service>();
+    const auto exe = PriorityStrandExecutor::create(io_service, { 2, 1 });
+
+    std::vector<int> order;
+    for (int i = 0; i < 3; ++i)
+    {
+        exe->post(1, [&order, i]() { order.push_back(100 + i); });
+    }
+    for (int i = 0; i < 5; ++i)
+    {
+        exe->post(0, [&order, i]() { order.push_back(i); });
+    }
+
+    io_service->run();
+
+    REQUIRE(order == std::vector<int>({ 0, 1, 100, 2, 3, 101, 4, 102 }));
+}
+
+TEST_CASE(SUITE("events without a lane go to the lowest priority lane"))
+{
+    const auto io_service = std::make_shared<asio::io_service>();
+    const auto exe = PriorityStrandExecutor::create(io_service, { 1, 1 });
+
+    std::vector<int> order;
+    exe->post([&]() { order.push_back(1); });
+    exe->post(0, [&]() { order.push_back(0); });
+
+    io_service->run();
+
+    REQUIRE(order == std::vector<int>({ 0, 1 }));
+}
+
+TEST_CASE(SUITE("a throwing event does not stop the lanes"))
+{
+    const auto io_service = std::make_shared<asio::io_service>();
+    const auto exe = PriorityStrandExecutor::create(io_service, { 1, 1 });
+
+    std::vector<int> order;
+    exe->post(0, []() { throw std::runtime_error("event failed"); });
+    exe->post(0, [&]() { order.push_back(0); });
+    exe->post(1, [&]() { order.push_back(1); });
+
+    REQUIRE_THROWS_AS(io_service->run(), std::runtime_error);
+    io_service->run();
+    REQUIRE(order == std::vector<int>({ 1, 0 }));
+
+    exe->post(0, [&]() { order.push_back(2); });
+    io_service->restart();
+    io_service->run();
+    REQUIRE(order == std::vector<int>({ 1, 0, 2 }));
+}
+
+TEST_CASE(SUITE("dispatch is serialized and in post order within a lane"))
+{
+    const int NUM_THREAD = 10;
+    const int NUM_OPS = 1000;
+
+    const auto io_service = std::make_shared<asio::io_service>();
+
+    int order[2] = { 0, 0 };
+    bool is_ordered = true;
+
+    {
+        ThreadPool pool(io_service, NUM_THREAD);
+        const auto exe = PriorityStrandExecutor::create(io_service, { 4, 1 });
+
+        for (int i = 0; i < NUM_OPS; ++i)
+        {
+            for (size_t lane = 0; lane < 2; ++lane)
+            {
+                exe->post(lane, [i, &order = order[lane], &is_ordered]()
+                {
+                    if (i == order)
+                    {
+                        ++order;
+                    }
+                    else
+                    {
+                        is_ordered = false;
+                    }
+                });
+            }
+        }
+    }
+
+    REQUIRE(is_ordered);
+    REQUIRE(order[0] == NUM_OPS);
+    REQUIRE(order[1] == NUM_OPS);
+}
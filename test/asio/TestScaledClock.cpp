@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/asio/ScaledClock.h"
+
+#include <vector>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "ScaledClockTestSuite - " name
+
+TEST_CASE(SUITE("executors on a scaled clock run timers faster than real time"))
+{
+    ScaledClock::set_scale(100.0);
+
+    const auto io_service = std::make_shared<asio::io_service>();
+    const auto basic = ScaledBasicExecutor::create(io_service);
+    const auto strand = ScaledStrandExecutor::create(io_service);
+
+    std::vector<int> order;
+    const auto scaled_start = basic->get_time();
+    const auto real_start = std::chrono::steady_clock::now();
+
+    strand->start(std::chrono::seconds(2), [&]() { order.push_back(2); });
+    basic->start(std::chrono::seconds(1), [&]() { order.push_back(1); });
+    auto canceled = strand->start(std::chrono::seconds(1), [&]() { order.push_back(-1); });
+    canceled.cancel();
+
+    io_service->run();
+
+    const auto real_elapsed = std::chrono::steady_clock::now() - real_start;
+    const auto scaled_elapsed = strand->get_time() - scaled_start;
+
+    ScaledClock::set_scale(1.0);
+
+    REQUIRE(order == std::vector<int>({ 1, 2 }));
+    REQUIRE(scaled_elapsed >= std::chrono::seconds(2));
+    REQUIRE(real_elapsed < std::chrono::seconds(1));
+}
+
+TEST_CASE(SUITE("changing the scale keeps the clock continuous"))
+{
+    const auto before = ScaledClock::now();
+    ScaledClock::set_scale(1000.0);
+    const auto during = ScaledClock::now();
+    ScaledClock::set_scale(1.0);
+    const auto after = ScaledClock::now();
+
+    REQUIRE(before <= during);
+    REQUIRE(during <= after);
+    REQUIRE(after - before < std::chrono::seconds(1));
+}
@@ -24,15 +24,44 @@
 */
 #include "catch.hpp"
 
+// the executors must stay forward declarable as classes
+namespace exe4cpp
+{
+class AsioTimer;
+class BasicExecutor;
+class StrandExecutor;
+}
+
 #include "exe4cpp/asio/ThreadPool.h"
 #include "exe4cpp/asio/StrandExecutor.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
 using namespace std;
 using namespace std::chrono;
 using namespace exe4cpp;
 
 #define SUITE(name) "StrandExecutorTestSuite - " name
 
+TEST_CASE(SUITE("fork returns a StrandExecutor"))
+{
+    const auto io_service = std::make_shared<asio::io_service>();
+    const std::shared_ptr<StrandExecutor> strand = StrandExecutor::create(io_service, StrandBudget{});
+    const std::shared_ptr<StrandExecutor> forked = strand->fork();
+
+    REQUIRE(forked != strand);
+    REQUIRE(forked->get_service() == io_service);
+    REQUIRE(forked->shared_from_this() == forked);
+}
+
 TEST_CASE(SUITE("automatically reclaims resources"))
 {
     const int NUM_THREAD = 10;
@@ -134,3 +163,196 @@ TEST_CASE(SUITE("Executor dispatch is in same order as post order"))
     REQUIRE(is_ordered);
 }
 
+TEST_CASE(SUITE("strands with a budget take turns on the io_service"))
+{
+    const auto io_service = std::make_shared<asio::io_service>();
+
+    StrandBudget budget;
+    budget.max_handlers = 2;
+
+    const auto first = StrandExecutor::create(io_service, budget);
+    const auto second = first->fork();
+
+    std::vector<int> order;
+    for (int i = 0; i < 4; ++i)
+    {
+        first->post([&order]() { order.push_back(1); });
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        second->post([&order]() { order.push_back(2); });
+    }
+
+    io_service->run();
+
+    REQUIRE(order == std::vector<int>({ 1, 1, 2, 2, 1, 1, 2, 2 }));
+}
+
+TEST_CASE(SUITE("a throwing handler does not stop a strand with a budget"))
+{
+    const auto io_service = std::make_shared<asio::io_service>();
+
+    StrandBudget budget;
+    budget.max_handlers = 10;
+    const auto exe = StrandExecutor::create(io_service, budget);
+
+    std::vector<int> order;
+    exe->post([]() { throw std::runtime_error("handler failed"); });
+    exe->post([&order]() { order.push_back(1); });
+
+    REQUIRE_THROWS_AS(io_service->run(), std::runtime_error);
+    io_service->run();
+    REQUIRE(order == std::vector<int>({ 1 }));
+
+    // the strand is idle again and accepts new events
+    exe->post([&order]() { order.push_back(2); });
+    io_service->restart();
+    io_service->run();
+    REQUIRE(order == std::vector<int>({ 1, 2 }));
+}
+
+TEST_CASE(SUITE("dispatch with a budget is serialized and in post order"))
+{
+    const int NUM_THREAD = 10;
+    const int NUM_OPS = 1000;
+
+    const auto io_service = std::make_shared<asio::io_service>();
+
+    StrandBudget budget;
+    budget.max_handlers = 3;
+    budget.max_time = std::chrono::microseconds(50);
+
+    int order = 0;
+    bool is_ordered = true;
+
+    {
+        ThreadPool pool(io_service, NUM_THREAD);
+        const auto exe = StrandExecutor::create(io_service, budget);
+
+        for (int i = 0; i < NUM_OPS; ++i)
+        {
+            auto test_order = [i, &order, &is_ordered]()
+            {
+                if (i == order)
+                {
+                    ++order;
+                }
+                else
+                {
+                    is_ordered = false;
+                }
+            };
+            exe->post(test_order);
+            exe->start(std::chrono::milliseconds(0), []() {});
+        }
+    }
+
+    REQUIRE(is_ordered);
+    REQUIRE(order == NUM_OPS);
+}
+
+TEST_CASE(SUITE("handlers share a cached timestamp, with or without a budget"))
+{
+    StrandBudget budget;
+    budget.max_handlers = 1;
+
+    for (const auto& b : { StrandBudget{}, budget })
+    {
+        const auto io_service = std::make_shared<asio::io_service>();
+        const auto cache = CachedTimeSource::create();
+        const auto exe = StrandExecutor::create(io_service, b, cache);
+
+        std::vector<steady_time_t> times;
+        const action_t record = [&]()
+        {
+            times.push_back(exe->get_time());
+            times.push_back(exe->get_time());
+            std::this_thread::sleep_for(milliseconds(1));
+        };
+
+        exe->post(record);
+        exe->post(record);
+        exe->fork()->post(record);
+        exe->start(milliseconds(0), record);
+        io_service->run();
+
+        REQUIRE(times.size() == 8);
+        for (size_t i = 0; i < times.size(); i += 2)
+        {
+            REQUIRE(times[i] == times[i + 1]);
+            if (i > 0)
+            {
+                REQUIRE(times[i - 1] < times[i]);
+            }
+        }
+    }
+}
+
+TEST_CASE(SUITE("coalesced timers run as one strand event"))
+{
+    for (auto b : {StrandBudget{}, StrandBudget{2, microseconds::zero()}})
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<int> order;
+        bool is_concurrent = false;
+        std::atomic<int> active{0};
+
+        const auto io_service = std::make_shared<asio::io_service>();
+        ThreadPool pool(io_service, 4);
+        const auto exe = StrandExecutor::create(io_service, b);
+
+        for (int i = 0; i < 10; ++i)
+        {
+            exe->start(milliseconds(5), [&, i]()
+            {
+                if (active.fetch_add(1) != 0)
+                {
+                    is_concurrent = true;
+                }
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    order.push_back(i);
+                }
+                active.fetch_sub(1);
+                cv.notify_one();
+            }, milliseconds(8));
+        }
+
+        std::unique_lock<std::mutex> lock{mutex};
+        REQUIRE(cv.wait_for(lock, seconds(5), [&]() { return order.size() == 10; }));
+        REQUIRE_FALSE(is_concurrent);
+        for (int i = 0; i < 10; ++i)
+        {
+            REQUIRE(order[i] == i);
+        }
+    }
+}
+
+TEST_CASE(SUITE("timers that expire together run as one batch in deadline order"))
+{
+    for (auto b : {StrandBudget{}, StrandBudget{100, microseconds::zero()}})
+    {
+        const auto io_service = std::make_shared<asio::io_service>();
+        const auto exe = StrandExecutor::create(io_service, b);
+
+        std::vector<int> delays(1000);
+        std::iota(delays.begin(), delays.end(), 0);
+        std::shuffle(delays.begin(), delays.end(), std::mt19937{});
+
+        const auto now = exe->get_time();
+        std::vector<int> order;
+        for (auto i : delays)
+        {
+            exe->start(now + microseconds(i), [&order, i]() { order.push_back(i); });
+        }
+
+        std::this_thread::sleep_for(milliseconds(5));
+        const auto num_handlers = io_service->run();
+
+        REQUIRE(order.size() == 1000);
+        REQUIRE(std::is_sorted(order.begin(), order.end()));
+        // one batch, the waits aborted by re-arming, and a turn per 100 events with a budget
+        REQUIRE(num_handlers < (b.is_limited() ? 40u : 30u));
+    }
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/linux/EpollExecutor.h"
+
+#include <cstdio>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "EpollExecutorTestSuite - " name
+
+TEST_CASE(SUITE("posted actions run in post order"))
+{
+    const auto executor = EpollExecutor::create();
+
+    std::vector<int> order;
+    for (int i = 0; i < 5; ++i)
+    {
+        executor->post([i, &order]() { order.push_back(i); });
+    }
+
+    REQUIRE(executor->poll() == 5);
+    REQUIRE(order == std::vector<int>({ 0, 1, 2, 3, 4 }));
+    REQUIRE(executor->poll() == 0);
+}
+
+TEST_CASE(SUITE("timers fire in deadline order and can be canceled"))
+{
+    const auto executor = EpollExecutor::create();
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<int> order;
+    executor->start(std::chrono::milliseconds(20), [&]() { order.push_back(2); });
+    executor->start(std::chrono::milliseconds(10), [&]() { order.push_back(1); });
+    auto canceled = executor->start(std::chrono::milliseconds(5), [&]() { order.push_back(-1); });
+    executor->start(std::chrono::milliseconds(30), [&]() { executor->stop(); });
+
+    REQUIRE(canceled.cancel());
+
+    executor->run();
+
+    REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(30));
+    REQUIRE(order == std::vector<int>({ 1, 2 }));
+
+    // the executor released the timers
+    REQUIRE_FALSE(canceled.cancel());
+}
+
+TEST_CASE(SUITE("a timer started from another thread wakes up the loop"))
+{
+    const auto executor = EpollExecutor::create();
+
+    // far timer, the loop must re-arm the timerfd for the nearer one
+    auto far = executor->start(std::chrono::hours(1), []() {});
+
+    std::thread thread([executor]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        executor->start(std::chrono::milliseconds(10), [executor]() { executor->stop(); });
+    });
+
+    executor->run();
+    thread.join();
+
+    REQUIRE(far.cancel());
+}
+
+TEST_CASE(SUITE("actions posted from many threads are all executed"))
+{
+    const int NUM_THREADS = 4;
+    const int NUM_OPS = 10000;
+
+    const auto executor = EpollExecutor::create();
+
+    int count = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; ++t)
+    {
+        threads.emplace_back([&]()
+        {
+            for (int i = 0; i < NUM_OPS; ++i)
+            {
+                executor->post([&]()
+                {
+                    if (++count == NUM_THREADS * NUM_OPS)
+                    {
+                        executor->stop();
+                    }
+                });
+            }
+        });
+    }
+
+    executor->run();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(count == NUM_THREADS * NUM_OPS);
+}
+
+TEST_CASE(SUITE("watched file descriptors invoke their callback"))
+{
+    const auto executor = EpollExecutor::create();
+
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+
+    std::vector<char> received;
+    executor->watch(fds[0], EPOLLIN, [&](uint32_t events)
+    {
+        REQUIRE((events & EPOLLIN) != 0);
+        char value;
+        REQUIRE(::read(fds[0], &value, 1) == 1);
+        received.push_back(value);
+        if (value == 'b')
+        {
+            executor->unwatch(fds[0]);
+            executor->stop();
+        }
+    });
+
+    ssize_t written = 0;
+    std::thread thread([&]()
+    {
+        written += ::write(fds[1], "a", 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        written += ::write(fds[1], "b", 1);
+    });
+
+    executor->run();
+    thread.join();
+
+    REQUIRE(written == 2);
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+
+    REQUIRE(received == std::vector<char>({ 'a', 'b' }));
+}
+
+TEST_CASE(SUITE("descriptors rejected by epoll throw and are not watched"))
+{
+    const auto executor = EpollExecutor::create();
+
+    // regular files cannot be polled
+    const auto file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    bool is_called = false;
+    REQUIRE_THROWS_AS(executor->watch(::fileno(file), EPOLLIN, [&](uint32_t) { is_called = true; }), std::system_error);
+    REQUIRE_THROWS_AS(executor->watch(-1, EPOLLIN, [&](uint32_t) { is_called = true; }), std::system_error);
+    std::fclose(file);
+
+    executor->post([]() {});
+    REQUIRE(executor->poll() == 1);
+    REQUIRE_FALSE(is_called);
+}
+
+TEST_CASE(SUITE("posts to a loop that is not sleeping do not write the eventfd"))
+{
+    const auto executor = EpollExecutor::create();
+
+    int count = 0;
+    std::function<void()> chain = [&]()
+    {
+        if (++count < 100)
+        {
+            executor->post(chain);
+        }
+    };
+    executor->post(chain);
+
+    while (executor->poll() > 0)
+    {
+    }
+
+    const auto stats = executor->get_stats();
+    REQUIRE(count == 100);
+    REQUIRE(stats.num_posts == 100);
+    REQUIRE(stats.num_posted_while_awake == 100);
+    REQUIRE(stats.num_wakeups == 0);
+}
+
+TEST_CASE(SUITE("a burst of posts to a sleeping loop is coalesced"))
+{
+    const int NUM_OPS = 10000;
+
+    const auto executor = EpollExecutor::create();
+
+    int count = 0;
+    std::thread thread([&]()
+    {
+        executor->run();
+    });
+
+    // let the loop go to sleep
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    for (int i = 0; i < NUM_OPS; ++i)
+    {
+        executor->post([&]() { ++count; });
+    }
+    executor->post([&]() { executor->stop(); });
+    thread.join();
+
+    const auto stats = executor->get_stats();
+    REQUIRE(count == NUM_OPS);
+    REQUIRE(stats.num_posts == NUM_OPS + 1);
+    REQUIRE(stats.num_wakeups >= 1);
+    REQUIRE(stats.num_wakeups + stats.num_coalesced + stats.num_posted_while_awake == stats.num_posts);
+    // the loop only needs a wakeup when it ran out of work. How often that happens depends on the
+    // scheduling of the two threads, but it is never close to once per post.
+    REQUIRE(stats.num_wakeups < NUM_OPS / 2);
+}
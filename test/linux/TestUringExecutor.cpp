@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2018, Automatak LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+ * disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "catch.hpp"
+
+#include "exe4cpp/linux/UringExecutor.h"
+
+#include <thread>
+#include <vector>
+
+using namespace exe4cpp;
+
+#define SUITE(name) "UringExecutorTestSuite - " name
+
+TEST_CASE(SUITE("the loop executor runs posts and timers with either backend"))
+{
+    const auto executor = create_loop_executor();
+
+    std::vector<int> order;
+    executor->start(std::chrono::milliseconds(20), [&]()
+    {
+        order.push_back(3);
+        executor->stop();
+    });
+    executor->start(std::chrono::milliseconds(10), [&]() { order.push_back(2); });
+    auto canceled = executor->start(std::chrono::milliseconds(5), [&]() { order.push_back(-1); });
+    executor->post([&]() { order.push_back(1); });
+    REQUIRE(canceled.cancel());
+
+    executor->run();
+
+    REQUIRE(order == std::vector<int>({ 1, 2, 3 }));
+}
+
+#if defined(EXE4CPP_HAS_IO_URING)
+
+TEST_CASE(SUITE("an earlier timer replaces the armed timeout"))
+{
+    if (!UringExecutor::is_supported())
+    {
+        WARN("io_uring is not available, skipped");
+        return;
+    }
+
+    const auto executor = UringExecutor::create();
+
+    std::vector<int> order;
+    executor->start(std::chrono::hours(1), [&]() { order.push_back(-1); });
+    REQUIRE(executor->poll() == 0);
+
+    const auto start = std::chrono::steady_clock::now();
+    executor->start(std::chrono::milliseconds(10), [&]()
+    {
+        order.push_back(1);
+        executor->stop();
+    });
+
+    executor->run();
+
+    REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(10));
+    REQUIRE(order == std::vector<int>({ 1 }));
+}
+
+TEST_CASE(SUITE("application operations complete on the loop"))
+{
+    if (!UringExecutor::is_supported())
+    {
+        WARN("io_uring is not available, skipped");
+        return;
+    }
+
+    const auto executor = UringExecutor::create();
+
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+
+    char buffer[8] = {};
+    int32_t read_result = 0;
+    executor->post([&]()
+    {
+        executor->submit([&](io_uring_sqe& sqe)
+        {
+            sqe.opcode = IORING_OP_POLL_ADD;
+            sqe.fd = fds[0];
+            sqe.poll_events = POLLIN;
+        },
+        [&](int32_t result)
+        {
+            read_result = result;
+            REQUIRE(::read(fds[0], buffer, sizeof(buffer)) == 5);
+            executor->stop();
+        });
+    });
+
+    ssize_t written = 0;
+    std::thread thread([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        written = ::write(fds[1], "hello", 5);
+    });
+
+    executor->run();
+    thread.join();
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+
+    REQUIRE(written == 5);
+    REQUIRE((read_result & POLLIN) != 0);
+    REQUIRE(std::string(buffer) == "hello");
+}
+
+TEST_CASE(SUITE("thousands of posts from other threads are all executed"))
+{
+    if (!UringExecutor::is_supported())
+    {
+        WARN("io_uring is not available, skipped");
+        return;
+    }
+
+    const int NUM_THREADS = 4;
+    const int NUM_OPS = 10000;
+
+    const auto executor = UringExecutor::create(8);
+
+    int count = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; ++t)
+    {
+        threads.emplace_back([&]()
+        {
+            for (int i = 0; i < NUM_OPS; ++i)
+            {
+                executor->post([&]()
+                {
+                    if (++count == NUM_THREADS * NUM_OPS)
+                    {
+                        executor->stop();
+                    }
+                });
+            }
+        });
+    }
+
+    executor->run();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(count == NUM_THREADS * NUM_OPS);
+}
+
+TEST_CASE(SUITE("more operations than the completion queue holds all complete"))
+{
+    if (!UringExecutor::is_supported())
+    {
+        WARN("io_uring is not available, skipped");
+        return;
+    }
+
+    const int NUM_OPS = 256;
+
+    // 4 submission and 8 completion queue entries
+    const auto executor = UringExecutor::create(4);
+
+    int count = 0;
+    executor->post([&]()
+    {
+        for (int i = 0; i < NUM_OPS; ++i)
+        {
+            executor->submit([](io_uring_sqe& sqe) { sqe.opcode = IORING_OP_NOP; }, [&](int32_t result)
+            {
+                REQUIRE(result == 0);
+                if (++count == NUM_OPS)
+                {
+                    executor->stop();
+                }
+            });
+        }
+    });
+
+    executor->run();
+
+    REQUIRE(count == NUM_OPS);
+}
+
+#endif